@@ -0,0 +1,74 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+
+#ifdef HOST_BUILD
+/* stand-in for the linker region, HEAP_SIZE from the Makefile */
+static uint8_t host_heap[HOST_HEAP_SIZE] __attribute__((aligned(16)));
+#else
+/* linker.ld */
+extern uint8_t __heap_start[], __heap_end[];
+#endif
+
+void arena_init(struct arena *a, void *base, size_t size)
+{
+    a->base = base;
+    a->size = size;
+    a->used = 0;
+    a->peak = 0;
+}
+
+void arena_init_heap(struct arena *a)
+{
+#ifdef HOST_BUILD
+    arena_init(a, host_heap, sizeof(host_heap));
+#else
+    arena_init(a, __heap_start, __heap_end - __heap_start);
+#endif
+}
+
+/* the absolute address is aligned, so a base that is not still works */
+void *arena_alloc_aligned(struct arena *a, size_t size, size_t align)
+{
+    uintptr_t p = (uintptr_t) a->base + a->used;
+    size_t pad = -p & (align - 1);
+
+    if (pad > a->size - a->used || size > a->size - a->used - pad)
+        return NULL;
+    a->used += pad + size;
+    if (a->used > a->peak)
+        a->peak = a->used;
+    return (void *) (p + pad);
+}
+
+void *arena_alloc(struct arena *a, size_t size)
+{
+    return arena_alloc_aligned(a, size, ARENA_ALIGN);
+}
+
+size_t arena_mark(const struct arena *a)
+{
+    return a->used;
+}
+
+void arena_reset(struct arena *a, size_t mark)
+{
+    if (mark < a->used)
+        a->used = mark;
+}
+
+size_t arena_used(const struct arena *a)
+{
+    return a->used;
+}
+
+size_t arena_peak(const struct arena *a)
+{
+    return a->peak;
+}
+
+void arena_reset_peak(struct arena *a)
+{
+    a->peak = a->used;
+}
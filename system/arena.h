@@ -0,0 +1,44 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Bump allocator over a fixed region (arena.c). Allocation moves one
+ * offset forward; nothing is freed on its own. arena_mark() records the
+ * offset and arena_reset() drops everything allocated after it, so nested
+ * scopes (a dataset, then per-kernel scratch) unwind in LIFO order.
+ *
+ * The region behind arena_init_heap() is the linker heap (__heap_start to
+ * __heap_end, sized with make HEAP_SIZE=), or a static buffer of the same
+ * size on host builds. It is not cleared at startup. 'peak' is the
+ * high-water mark of 'used' and survives resets; read it to size
+ * HEAP_SIZE for a dataset.
+ */
+
+#define ARENA_ALIGN 4 /* arena_alloc: word aligned */
+
+struct arena {
+    uint8_t *base;
+    size_t size;
+    size_t used;
+    size_t peak;
+};
+
+void arena_init(struct arena *a, void *base, size_t size);
+/* the whole linker heap */
+void arena_init_heap(struct arena *a);
+
+/* NULL (and no change) when the region is full; size 0 is allowed */
+void *arena_alloc(struct arena *a, size_t size);
+/* align is a power of two, e.g. 16 for bf16x2 vectors or 64 for a line */
+void *arena_alloc_aligned(struct arena *a, size_t size, size_t align);
+
+size_t arena_mark(const struct arena *a);
+void arena_reset(struct arena *a, size_t mark);
+
+size_t arena_used(const struct arena *a);
+size_t arena_peak(const struct arena *a);
+void arena_reset_peak(struct arena *a);
+
+#endif /* ARENA_H */
@@ -0,0 +1,255 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bench.h"
+#include "fmt.h"
+#include "output.h"
+
+extern uint64_t get_cycles(void);
+extern uint64_t get_instret(void);
+
+/* build profile the numbers belong to, from the Makefile */
+#ifndef BENCH_BUILD
+#define BENCH_BUILD "-"
+#endif
+
+#ifdef BENCH_FORMAT_CSV
+static enum bench_format bench_fmt = BENCH_CSV;
+#else
+static enum bench_format bench_fmt = BENCH_TEXT;
+#endif
+static unsigned bench_reps = BENCH_DEFAULT_REPS;
+static bool bench_csv_header;
+
+/* Cost of an empty measurement bracket */
+static bool bench_calibrated;
+static uint64_t bench_cycles_overhead, bench_instret_overhead;
+
+void bench_set_reps(unsigned reps)
+{
+    if (reps == 0)
+        reps = 1;
+    if (reps > BENCH_MAX_REPS)
+        reps = BENCH_MAX_REPS;
+    bench_reps = reps;
+}
+
+void bench_set_format(enum bench_format format)
+{
+    bench_fmt = format;
+}
+
+static void bench_empty(void) {}
+
+static void bench_sample(void (*run)(void), uint64_t *cycles, uint64_t *instret)
+{
+    uint64_t start_instret = get_instret();
+    uint64_t start_cycles = get_cycles();
+    run();
+    uint64_t end_cycles = get_cycles();
+    uint64_t end_instret = get_instret();
+
+    *cycles = end_cycles - start_cycles;
+    *instret = end_instret - start_instret;
+}
+
+static void bench_sort(uint64_t *v, unsigned n)
+{
+    for (unsigned i = 1; i < n; i++) {
+        uint64_t x = v[i];
+        unsigned j = i;
+
+        for (; j > 0 && v[j - 1] > x; j--)
+            v[j] = v[j - 1];
+        v[j] = x;
+    }
+}
+
+static void bench_calibrate(void)
+{
+    uint64_t cycles, instret;
+
+    bench_cycles_overhead = ~0ULL;
+    bench_instret_overhead = ~0ULL;
+    for (unsigned r = 0; r < BENCH_DEFAULT_REPS; r++) {
+        bench_sample(bench_empty, &cycles, &instret);
+        if (cycles < bench_cycles_overhead)
+            bench_cycles_overhead = cycles;
+        if (instret < bench_instret_overhead)
+            bench_instret_overhead = instret;
+    }
+    bench_calibrated = true;
+}
+
+void bench_measure(const struct bench_case *c, struct bench_stats *st)
+{
+    uint64_t cycles[BENCH_MAX_REPS], instret[BENCH_MAX_REPS];
+    unsigned reps = c->reps ? c->reps : bench_reps;
+
+    if (reps > BENCH_MAX_REPS)
+        reps = BENCH_MAX_REPS;
+    if (!bench_calibrated)
+        bench_calibrate();
+    if (c->setup)
+        c->setup();
+    if (reps > 1)
+        c->run();
+
+    for (unsigned r = 0; r < reps; r++) {
+        bench_sample(c->run, &cycles[r], &instret[r]);
+        cycles[r] = cycles[r] > bench_cycles_overhead
+                        ? cycles[r] - bench_cycles_overhead
+                        : 0;
+        instret[r] = instret[r] > bench_instret_overhead
+                         ? instret[r] - bench_instret_overhead
+                         : 0;
+    }
+    bench_sort(cycles, reps);
+    bench_sort(instret, reps);
+    st->min = cycles[0];
+    st->median = cycles[reps >> 1];
+    st->max = cycles[reps - 1];
+    st->instret = instret[reps >> 1];
+}
+
+/* n / d by shift-subtract with constant shifts only (no libgcc) */
+static uint64_t bench_div(uint64_t n, uint64_t d)
+{
+    uint64_t q = 0, r = 0;
+
+    if (d == 0)
+        return 0;
+    for (int i = 0; i < 64; i++) {
+        r = (r << 1) | (n >> 63);
+        n <<= 1;
+        q <<= 1;
+        if (r >= d) {
+            r -= d;
+            q |= 1;
+        }
+    }
+    return q;
+}
+
+/* num / den with 'decimals' fractional digits, right-aligned in 'width' */
+static void bench_put_fixed(uint64_t num,
+                            uint64_t den,
+                            unsigned decimals,
+                            unsigned width)
+{
+    char digits[FMT_U64_MAX];
+    size_t n;
+
+    for (unsigned i = 0; i < decimals; i++)
+        num = (num << 3) + (num << 1);
+    n = fmt_u64(digits, bench_div(num, den), decimals + 1, FMT_ZERO);
+    for (unsigned len = n + 1; len < width; len++)
+        out_putc(' ');
+    out_write(digits, n - decimals);
+    out_putc('.');
+    out_write(digits + n - decimals, decimals);
+}
+
+static void bench_put_name(const char *name, unsigned width)
+{
+    unsigned len = 0;
+
+    while (name[len])
+        len++;
+    out_write(name, len);
+    for (; len < width; len++)
+        out_putc(' ');
+}
+
+void bench_header(const char *suite)
+{
+    if (!bench_calibrated)
+        bench_calibrate();
+
+    if (bench_fmt == BENCH_CSV) {
+        if (!bench_csv_header) {
+            out_puts("build,suite,case,ops,reps,min,median,max,instret,"
+                     "cycles_per_op,ipc,bytes_per_cycle,macs_per_cycle\n");
+            bench_csv_header = true;
+        }
+        return;
+    }
+    out_puts("--------------------\nBench: ");
+    out_puts(suite);
+    out_puts(" [" BENCH_BUILD "] (overhead ");
+    out_u64(bench_cycles_overhead, 0, 0);
+    out_puts(" cycles, ");
+    out_u64(bench_instret_overhead, 0, 0);
+    out_puts(" instructions)\n");
+    out_puts("  case                       min    median       max"
+             "    cyc/op   IPC\n");
+}
+
+void bench_report(const char *suite,
+                  const struct bench_case *c,
+                  const struct bench_stats *st)
+{
+    uint32_t ops = c->ops ? c->ops : 1;
+    unsigned reps = c->reps ? c->reps : bench_reps;
+
+    if (reps > BENCH_MAX_REPS)
+        reps = BENCH_MAX_REPS;
+
+    if (bench_fmt == BENCH_CSV) {
+        out_puts(BENCH_BUILD ",");
+        out_puts(suite);
+        out_putc(',');
+        out_puts(c->name);
+        out_putc(',');
+        out_u64(ops, 0, 0);
+        out_putc(',');
+        out_u64(reps, 0, 0);
+        out_putc(',');
+        out_u64(st->min, 0, 0);
+        out_putc(',');
+        out_u64(st->median, 0, 0);
+        out_putc(',');
+        out_u64(st->max, 0, 0);
+        out_putc(',');
+        out_u64(st->instret, 0, 0);
+        out_putc(',');
+        bench_put_fixed(st->median, ops, 1, 0);
+        out_putc(',');
+        bench_put_fixed(st->instret, st->median, 2, 0);
+        out_putc(',');
+        if (c->bytes)
+            bench_put_fixed(c->bytes, st->median, 2, 0);
+        out_putc(',');
+        if (c->macs)
+            bench_put_fixed(c->macs, st->median, 4, 0);
+        out_putc('\n');
+        return;
+    }
+    out_puts("  ");
+    bench_put_name(c->name, 20);
+    out_u64(st->min, 10, 0);
+    out_u64(st->median, 10, 0);
+    out_u64(st->max, 10, 0);
+    bench_put_fixed(st->median, ops, 1, 10);
+    bench_put_fixed(st->instret, st->median, 2, 6);
+    if (c->bytes) {
+        bench_put_fixed(c->bytes, st->median, 2, 8);
+        out_puts(" B/cyc");
+    }
+    if (c->macs) {
+        bench_put_fixed(c->macs, st->median, 4, 8);
+        out_puts(" MAC/cyc");
+    }
+    out_putc('\n');
+}
+
+void bench_run(const char *suite, const struct bench_case *cases, unsigned n)
+{
+    struct bench_stats st;
+
+    bench_header(suite);
+    for (unsigned i = 0; i < n; i++) {
+        bench_measure(&cases[i], &st);
+        bench_report(suite, &cases[i], &st);
+    }
+}
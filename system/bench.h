@@ -0,0 +1,51 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+/* Micro-benchmark harness (bench.c).
+ *
+ * A case is measured 'reps' times after one warm-up run. Every sample is
+ * bracketed by get_instret/get_cycles and has the cost of an empty
+ * bracket, calibrated once on first use, subtracted. Results are printed
+ * as a text table or, when built with BENCH_FORMAT=csv, as CSV rows that
+ * can be collected from several builds and compared; both are tagged with
+ * the BENCH_BUILD string (the Makefile passes PROFILE).
+ */
+
+#define BENCH_MAX_REPS 31
+#define BENCH_DEFAULT_REPS 9
+
+struct bench_case {
+    const char *name;
+    void (*setup)(void); /* optional, once before the warm-up */
+    void (*run)(void);   /* the measured body */
+    uint32_t ops;        /* operations per run, for cycles/op (0: 1) */
+    unsigned reps;       /* 0: bench default; 1: single run, no warm-up */
+    uint32_t bytes;      /* bytes read + written per run, for B/cycle */
+    uint32_t macs;       /* multiply-accumulates per run, for MAC/cycle */
+};
+
+struct bench_stats {
+    uint64_t min, median, max; /* cycles */
+    uint64_t instret;          /* median instructions retired */
+};
+
+enum bench_format {
+    BENCH_TEXT,
+    BENCH_CSV,
+};
+
+void bench_set_reps(unsigned reps);
+void bench_set_format(enum bench_format format);
+
+void bench_measure(const struct bench_case *c, struct bench_stats *st);
+void bench_header(const char *suite);
+void bench_report(const char *suite,
+                  const struct bench_case *c,
+                  const struct bench_stats *st);
+
+/* bench_header, then bench_measure and bench_report for every case */
+void bench_run(const char *suite, const struct bench_case *cases, unsigned n);
+
+#endif /* BENCH_H */
@@ -0,0 +1,663 @@
+/* Host-side generator for the bf16 conformance golden tables.
+ *
+ * The reference functions below restate, in plain C, what the bf16 layout
+ * of the kernels in bfloat16.S computes: truncating add/mul/div, the
+ * binary-search sqrt and the exact special-case order of each routine.
+ * They are the contract the assembly has to keep when it is optimised,
+ * so they model the current results bit for bit, not IEEE rounding.
+ *
+ *   bf16_golden_sqrt   65536 halfwords, my_sqrt of every encoding
+ *   bf16_golden_class  65536 bytes, GOLDEN_NAN/INF/ZERO flags
+ *   bf16_golden_cvt    65536 {low half, f32_to_bf16} pairs: the input is
+ *                      (x << 16) | low half, with a seeded low half
+ *   bf16_golden_pairs  bf16_golden_npairs rows of
+ *                      {a, b, add, sub, mul, div, cmp flags, 0}
+ *   bf16_golden_fma    bf16_golden_npairs rows of {a, b, c, fma}
+ *   bf16_golden_math   65536 rows of {exp, log2, sigmoid, tanh, recip}
+ *   q16_golden         q16_golden_rows rows of {x, sqrt, rsqrt, xs, recip,
+ *                      a, sin, cos, y, x2, atan2}, Q16.16 words
+ *
+ * bf16_fma is the exception to the above: it rounds once, to nearest even,
+ * so its reference is the exact result, worked out in double arithmetic
+ * rather than by restating the kernel. The bf16_math.S references are the
+ * libm results rounded to nearest even; the kernels only promise 1 ulp, so
+ * main.c measures the distance instead of matching bits. The same goes
+for q16.c: its references are long double libm results rounded to the
+nearest Q16 step, and main.c allows each function a few steps of error.
+ *
+ * Usage: bf16_golden [seed [pairs]] > bf16_golden.S
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GOLDEN_NAN 0x1
+#define GOLDEN_INF 0x2
+#define GOLDEN_ZERO 0x4
+
+#define GOLDEN_EQ 0x1
+#define GOLDEN_LT 0x2
+#define GOLDEN_GT 0x4
+
+#define BF16_QNAN 0x7FC0
+
+#define Q16_GOLDEN_ROWS 1024
+
+static uint32_t rng_state;
+
+static uint32_t xorshift32(void)
+{
+    uint32_t x = rng_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return rng_state = x;
+}
+
+static uint16_t f32_to_bf16_ref(uint32_t x)
+{
+    if (((x >> 23) & 0xFF) == 0xFF)
+        return x >> 16;
+    return (x + 0x7FFF + ((x >> 16) & 1)) >> 16;
+}
+
+static int is_nan_ref(uint32_t x)
+{
+    return (x & 0x7F) && ((x >> 7) & 0xFF) == 0xFF;
+}
+
+static int is_inf_ref(uint32_t x)
+{
+    return !(x & 0x7F) && ((x >> 7) & 0xFF) == 0xFF;
+}
+
+static int is_zero_ref(uint32_t x)
+{
+    return (x & 0x7FFF) == 0;
+}
+
+static int is_eq_ref(uint32_t a, uint32_t b)
+{
+    if (is_nan_ref(a) || is_nan_ref(b))
+        return 0;
+    if (is_zero_ref(a) && is_zero_ref(b))
+        return 1;
+    return a == b;
+}
+
+/* is_lt finishes by re-entering is_eq with the mantissa mask widened to
+ * 0x7FFF, which also treats infinities as NaN there: lt(inf, inf) is 1.
+ */
+static int is_lt_ref(uint32_t a, uint32_t b)
+{
+    uint32_t sa = a >> 15, sb = b >> 15;
+
+    if (is_nan_ref(a) || is_nan_ref(b))
+        return 0;
+    if (is_zero_ref(a) && is_zero_ref(b))
+        return 0;
+    if (sa != sb)
+        return sa > sb;
+    if (sa)
+        return a >= b;
+    if (b < a)
+        return 0;
+    if (((a >> 7) & 0xFF) == 0xFF || ((b >> 7) & 0xFF) == 0xFF)
+        return 1;
+    return a != b;
+}
+
+static uint32_t add_ref(uint32_t a, uint32_t b)
+{
+    uint32_t sa = a >> 15, sb = b >> 15;
+    int32_t ea = (a >> 7) & 0xFF, eb = (b >> 7) & 0xFF, exp;
+    uint32_t ma = a & 0x7F, mb = b & 0x7F, sign, mant;
+    int32_t d;
+
+    if (ea == 0xFF) {
+        if (ma || eb != 0xFF)
+            return a;
+        if (mb || sa == sb)
+            return b;
+        return BF16_QNAN;
+    }
+    if (eb == 0xFF)
+        return b;
+    if (ea == 0 && ma == 0)
+        return b;
+    if (eb == 0 && mb == 0)
+        return a;
+    if (ea)
+        ma |= 0x80;
+    if (eb)
+        mb |= 0x80;
+
+    d = ea - eb;
+    if (d >= 0) {
+        if (d > 8)
+            return a;
+        exp = ea;
+        mb >>= d;
+    } else {
+        if (d < -8)
+            return b;
+        exp = eb;
+        ma >>= -d;
+    }
+
+    if (sa == sb) {
+        sign = sa;
+        mant = ma + mb;
+        if (mant & 0x100) {
+            mant >>= 1;
+            if (++exp >= 0xFF)
+                return (sign << 15) | 0x7F80;
+        }
+    } else {
+        sign = (ma < mb) ? sb : sa;
+        mant = (ma < mb) ? mb - ma : ma - mb;
+        if (!mant)
+            return 0;
+        while (!(mant & 0x80)) {
+            mant <<= 1;
+            exp--;
+        }
+    }
+    return (sign << 15) | ((exp & 0xFF) << 7) | (mant & 0x7F);
+}
+
+static uint32_t mul_ref(uint32_t a, uint32_t b)
+{
+    int32_t ea = (a >> 7) & 0xFF, eb = (b >> 7) & 0xFF, exp, adj = 0;
+    uint32_t ma = a & 0x7F, mb = b & 0x7F, prod, mant;
+    uint32_t sign = (a ^ b) >> 15;
+    uint32_t inf = (sign << 15) | 0x7F80, zero = sign << 15;
+
+    if (ea == 0xFF) {
+        if (ma)
+            return a;
+        return (eb || mb) ? inf : BF16_QNAN;
+    }
+    if (eb == 0xFF) {
+        if (mb)
+            return b;
+        return (ea || ma) ? inf : BF16_QNAN;
+    }
+    if ((ea == 0 && ma == 0) || (eb == 0 && mb == 0))
+        return zero;
+
+    /* subnormals are normalised into the exponent adjustment */
+    if (ea)
+        ma |= 0x80;
+    else
+        for (ea = 1; !(ma & 0x80); adj--)
+            ma <<= 1;
+    if (eb)
+        mb |= 0x80;
+    else
+        for (eb = 1; !(mb & 0x80); adj--)
+            mb <<= 1;
+
+    prod = ma * mb;
+    exp = ea + eb + adj - 127;
+    if (prod & 0x8000) {
+        mant = (prod >> 8) & 0x7F;
+        exp++;
+    } else {
+        mant = (prod >> 7) & 0x7F;
+    }
+    if (exp >= 0xFF)
+        return inf;
+    if (exp <= 0) {
+        if (exp < -6)
+            return zero;
+        mant >>= 1 - exp;
+        exp = 0;
+    }
+    return (sign << 15) | (exp << 7) | mant;
+}
+
+static uint32_t div_ref(uint32_t a, uint32_t b)
+{
+    int32_t ea = (a >> 7) & 0xFF, eb = (b >> 7) & 0xFF, exp;
+    uint32_t ma = a & 0x7F, mb = b & 0x7F, q = 0;
+    uint32_t sign = (a ^ b) >> 15;
+    uint32_t inf = (sign << 15) | 0x7F80, zero = sign << 15;
+
+    if (eb == 0xFF) {
+        if (mb)
+            return b;
+        return (ea == 0xFF && !ma) ? BF16_QNAN : zero;
+    }
+    if (eb == 0 && mb == 0)
+        return (ea || ma) ? inf : BF16_QNAN;
+    if (ea == 0xFF)
+        return ma ? a : inf;
+    if (ea == 0 && ma == 0)
+        return zero;
+    if (ea)
+        ma |= 0x80;
+    if (eb)
+        mb |= 0x80;
+
+    ma <<= 15;
+    for (int i = 15; i >= 0; i--) {
+        q <<= 1;
+        if (ma >= mb << i) {
+            ma -= mb << i;
+            q |= 1;
+        }
+    }
+
+    exp = ea - eb + 127;
+    if (!ea)
+        exp--;
+    if (!eb)
+        exp++;
+    while (!(q & 0x8000) && exp > 1) {
+        q <<= 1;
+        exp--;
+    }
+    q >>= 8;
+    if (exp >= 0xFF)
+        return inf;
+    if (exp <= 0)
+        return zero;
+    return (sign << 15) | (exp << 7) | (q & 0x7F);
+}
+
+static uint32_t sqrt_ref(uint32_t a)
+{
+    int32_t e = (a >> 7) & 0xFF, exp;
+    uint32_t m = a & 0x7F;
+    int32_t low = 90, high = 256, r = 128;
+
+    if (e == 0xFF)
+        return (!m && (a & 0x8000)) ? BF16_QNAN : a;
+    if (e == 0 && m == 0)
+        return 0;
+    if (a & 0x8000)
+        return BF16_QNAN;
+    if (e == 0)
+        return 0;
+
+    exp = e - 127;
+    m |= 0x80;
+    if (exp & 1) {
+        m <<= 1;
+        exp = ((exp - 1) >> 1) + 127;
+    } else {
+        exp = (exp >> 1) + 127;
+    }
+    while (low <= high) {
+        int32_t mid = (low + high) >> 1;
+
+        r = mid;
+        if ((int32_t) m < (mid * mid) >> 7)
+            high = mid - 1;
+        else
+            low = mid + 1;
+    }
+    if (r >= 256) {
+        r >>= 1;
+        exp++;
+    }
+    return (exp << 7) | (r & 0x7F);
+}
+
+/* a*b + c rounded once to nearest even. The product is exact in a double,
+ * TwoSum gives the sum's rounding error exactly, and rounding to odd on
+ * that error keeps the final rounding to bf16 from rounding twice.
+ */
+static double bf16_to_double(uint32_t x)
+{
+    uint32_t bits = x << 16;
+    float f;
+
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+static uint32_t double_to_bf16_rne(double v)
+{
+    uint64_t bits, sig, rest, half;
+    uint32_t sign, mant;
+    int32_t e, shift;
+
+    memcpy(&bits, &v, sizeof(bits));
+    sign = (bits >> 48) & 0x8000;
+    e = (int32_t) ((bits >> 52) & 0x7FF) - 1023 + 127;
+    if (!(bits << 1))
+        return sign;
+    sig = (bits & ((1ULL << 52) - 1)) | (1ULL << 52);
+    shift = (e >= 1) ? 45 : 46 - e;    /* subnormal below exponent 1 */
+    if (shift >= 64)
+        return sign;
+    mant = sig >> shift;
+    rest = sig & ((1ULL << shift) - 1);
+    half = 1ULL << (shift - 1);
+    if (rest > half || (rest == half && (mant & 1)))
+        mant++;
+    if (e >= 1)
+        mant += (uint32_t) (e - 1) << 7; /* hidden bit carries into exp */
+    if (mant >= 0x7F80)
+        return sign | 0x7F80;
+    return sign | mant;
+}
+
+static uint32_t fma_ref(uint32_t a, uint32_t b, uint32_t c)
+{
+    uint32_t sp = (a ^ b) & 0x8000;
+    double p, s, bb, err;
+    uint64_t bits;
+
+    if (is_nan_ref(a))
+        return a;
+    if (is_nan_ref(b))
+        return b;
+    if (is_nan_ref(c))
+        return c;
+    if (is_inf_ref(a) || is_inf_ref(b)) {
+        if (is_zero_ref(a) || is_zero_ref(b))
+            return BF16_QNAN;
+        if (is_inf_ref(c) && (c & 0x8000) != sp)
+            return BF16_QNAN;
+        return sp | 0x7F80;
+    }
+    if (is_inf_ref(c))
+        return c;
+
+    p = bf16_to_double(a) * bf16_to_double(b);
+    s = p + bf16_to_double(c);
+    bb = s - p;
+    err = (p - (s - bb)) + (bf16_to_double(c) - bb);
+    memcpy(&bits, &s, sizeof(bits));
+    if (err != 0 && !(bits & 1))
+        bits += ((err > 0) == (s > 0)) ? 1 : -1;
+    memcpy(&s, &bits, sizeof(s));
+    return double_to_bf16_rne(s);
+}
+
+/* One operand pair. Half the pairs are uniform over all encodings; the
+ * rest are steered to where the kernels branch: close exponents (add
+ * cancellation, div near 1), special values and subnormals.
+ */
+static const uint16_t special[] = {
+    0x0000, 0x8000, 0x7F80, 0xFF80, 0x7FC0, 0xFFC1, 0x0001, 0x807F,
+    0x0080, 0x7F7F, 0xFF7F, 0x3F80, 0xBF80, 0x4000, 0x0100, 0x7F00,
+};
+
+/* libm result of a bf16_math.S function on x, rounded to nearest even
+ * with the kernels' conventions: subnormal x reads as zero, a result below
+ * the normal range (after rounding) flushes to zero, NaN x comes back */
+static uint32_t math_ref(uint32_t x, int fn)
+{
+    uint32_t sign = x & 0x8000, r;
+    double d = ((x >> 7) & 0xFF) ? bf16_to_double(x) : (sign ? -0.0 : 0.0);
+    double v;
+
+    if ((x & 0x7FFF) > 0x7F80)
+        return x;
+    switch (fn) {
+    case 0:
+        v = exp(d);
+        break;
+    case 1:
+        v = log2(d);
+        break;
+    case 2:
+        v = 1.0 / (1.0 + exp(-d));
+        break;
+    case 3:
+        v = tanh(d);
+        break;
+    default:
+        v = 1.0 / d;
+        break;
+    }
+    if (isnan(v))
+        return BF16_QNAN;
+    if (v != 0 && !isinf(v) && fabs(v) < ldexp(1.0, -126)) {
+        /* round at full precision as if the exponent went on */
+        int e;
+        double f = frexp(fabs(v), &e);
+
+        if (nearbyint(ldexp(f, 8)) != 256.0 || e != -126)
+            return (v < 0) ? 0x8000 : 0;
+    }
+    r = double_to_bf16_rne(v);
+    if (!(r & 0x7F80))
+        return r & 0x8000;
+    return r;
+}
+
+/* a random word shifted right by 0..31, so that every magnitude shows */
+static uint32_t gen_log_uniform(void)
+{
+    uint32_t r = xorshift32();
+
+    return xorshift32() >> (r & 31);
+}
+
+static int32_t gen_signed(void)
+{
+    uint32_t r = xorshift32(), v = xorshift32() >> ((r & 31) | 1);
+
+    return (r & 0x80000000) ? -(int32_t) v : (int32_t) v;
+}
+
+static int32_t q16_round(long double v)
+{
+    return (int32_t) llroundl(ldexpl(v, 16));
+}
+
+/* one q16_golden row: sqrt and rsqrt of x, recip of xs, sin and cos of a,
+ * atan2(y, x2); q16_recip saturates at |xs| <= 2 */
+static void q16_row(uint32_t *row, uint32_t x, int32_t xs, int32_t a,
+                    int32_t y, int32_t x2)
+{
+    long double lx = ldexpl(x, -16), la = ldexpl(a, -16);
+
+    row[0] = x;
+    row[1] = (uint32_t) llroundl(sqrtl(ldexpl(x, 16)));
+    row[2] = x ? (uint32_t) llroundl(ldexpl(1, 16) / sqrtl(lx)) : 0xFFFFFFFF;
+    row[3] = xs;
+    if (xs >= -2 && xs <= 2)
+        row[4] = (xs < 0) ? 0x80000000 : 0x7FFFFFFF;
+    else
+        row[4] = q16_round(1 / ldexpl(xs, -16));
+    row[5] = a;
+    row[6] = q16_round(sinl(la));
+    row[7] = q16_round(cosl(la));
+    row[8] = y;
+    row[9] = x2;
+    row[10] = (y | x2) ? q16_round(atan2l(y, x2)) : 0;
+}
+
+static void gen_pair(uint32_t *a, uint32_t *b)
+{
+    uint32_t r = xorshift32();
+
+    *a = xorshift32() & 0xFFFF;
+    *b = xorshift32() & 0xFFFF;
+    switch (r & 7) {
+    case 4:
+    case 5: /* exponents within +-8 of each other */
+        *b = (*b & 0x807F) |
+             ((((*a >> 7) & 0xFF) + ((r >> 3) & 0xF) - 8) & 0xFF) << 7;
+        break;
+    case 6:
+        if (r & 8)
+            *a = special[(r >> 4) & 15];
+        else
+            *b = special[(r >> 4) & 15];
+        break;
+    case 7: /* subnormal or minimum exponent */
+        *a &= (r & 8) ? 0x80FF : 0x807F;
+        break;
+    default:
+        break;
+    }
+}
+
+/* The addend of an fma triple, steered to where a single rounding shows:
+ * near -(a*b) (cancellation), a few exponents below the product (ties,
+ * sticky bits), or special. The truncated product is close enough.
+ */
+static uint32_t gen_addend(uint32_t a, uint32_t b)
+{
+    uint32_t r = xorshift32(), c = xorshift32() & 0xFFFF;
+    uint32_t p = mul_ref(a, b);
+
+    switch (r & 7) {
+    case 2:
+    case 3:
+        c = ((p ^ 0x8000) + ((r >> 3) & 3) - 1) & 0xFFFF;
+        break;
+    case 4:
+    case 5:
+        c = (c & 0x807F) |
+            ((((p >> 7) & 0xFF) - 1 - ((r >> 3) & 15)) & 0xFF) << 7;
+        break;
+    case 6:
+        c = special[(r >> 3) & 15];
+        break;
+    default:
+        break;
+    }
+    return c;
+}
+
+static void emit_label(const char *name, int align)
+{
+    printf("\n.balign %d\n.globl %s\n%s:\n", align, name, name);
+}
+
+static void emit_halves(const uint16_t *v, size_t n, int per_line)
+{
+    for (size_t i = 0; i < n; i++) {
+        printf("%s0x%04x", (i % per_line) ? ", " : "    .hword ", v[i]);
+        if (i % per_line == (size_t) per_line - 1 || i == n - 1)
+            printf("\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seed = (argc > 1) ? strtoul(argv[1], NULL, 0) : 0x2545F491;
+    uint32_t npairs = (argc > 2) ? strtoul(argv[2], NULL, 0) : 8192;
+    static uint16_t cvt[2 * 65536], row[8];
+
+    rng_state = seed ? seed : 1;
+
+    printf("# Generated by bf16_golden.c (seed 0x%08x), do not edit.\n", seed);
+    printf(".section .rodata\n");
+
+    emit_label("bf16_golden_sqrt", 2);
+    for (uint32_t x = 0; x < 65536; x++) {
+        printf("%s0x%04x", (x & 7) ? ", " : "    .hword ", sqrt_ref(x));
+        if ((x & 7) == 7)
+            printf("\n");
+    }
+
+    emit_label("bf16_golden_class", 1);
+    for (uint32_t x = 0; x < 65536; x++) {
+        int c = (is_nan_ref(x) ? GOLDEN_NAN : 0) |
+                (is_inf_ref(x) ? GOLDEN_INF : 0) |
+                (is_zero_ref(x) ? GOLDEN_ZERO : 0);
+
+        printf("%s%d", (x & 15) ? ", " : "    .byte  ", c);
+        if ((x & 15) == 15)
+            printf("\n");
+    }
+
+    emit_label("bf16_golden_cvt", 2);
+    for (uint32_t x = 0; x < 65536; x++) {
+        uint32_t lo = xorshift32() & 0xFFFF;
+
+        /* every 64th encoding gets an exact tie to pin round-to-even */
+        if ((x & 63) == 0)
+            lo = 0x8000;
+        cvt[2 * x] = lo;
+        cvt[2 * x + 1] = f32_to_bf16_ref(x << 16 | lo);
+    }
+    emit_halves(cvt, 2 * 65536, 8);
+
+    emit_label("bf16_golden_npairs", 4);
+    printf("    .4byte %u\n", npairs); /* .word is 16-bit on x86 */
+    emit_label("bf16_golden_pairs", 2);
+    for (uint32_t i = 0; i < npairs; i++) {
+        uint32_t a, b;
+
+        gen_pair(&a, &b);
+        row[0] = a;
+        row[1] = b;
+        row[2] = add_ref(a, b);
+        row[3] = add_ref(a, b ^ 0x8000);
+        row[4] = mul_ref(a, b);
+        row[5] = div_ref(a, b);
+        row[6] = (is_eq_ref(a, b) ? GOLDEN_EQ : 0) |
+                 (is_lt_ref(a, b) ? GOLDEN_LT : 0) |
+                 (is_lt_ref(b, a) ? GOLDEN_GT : 0);
+        row[7] = 0;
+        emit_halves(row, 8, 8);
+    }
+
+    emit_label("bf16_golden_fma", 2);
+    for (uint32_t i = 0; i < npairs; i++) {
+        uint32_t a, b, c;
+
+        gen_pair(&a, &b);
+        c = gen_addend(a, b);
+        row[0] = a;
+        row[1] = b;
+        row[2] = c;
+        row[3] = fma_ref(a, b, c);
+        emit_halves(row, 4, 4);
+    }
+
+    emit_label("bf16_golden_math", 2);
+    for (uint32_t x = 0; x < 65536; x++) {
+        for (int fn = 0; fn < 5; fn++)
+            row[fn] = math_ref(x, fn);
+        emit_halves(row, 5, 5);
+    }
+
+    /* edges first: 1, one, the top, recip saturation, axes */
+    static const int32_t q16_edge[][5] = {
+        {1, 3, 0, 0, 1},
+        {0x10000, 0x10000, 205887, 1, 0},
+        {0x7FFFFFFF, -3, -205887, 0, -1},
+        {-1, 2, 0x7FFFFFFF, -1, 0},
+        {0x3FFFFFFF, -2, (int32_t) 0x80000000, -1, -1},
+        {2, -0x10000, 102944, 0x7FFFFFFF, -0x7FFFFFFF},
+        {3, 0, -102944, 0, 0},
+    };
+    const uint32_t q16_edges = sizeof(q16_edge) / sizeof(q16_edge[0]);
+    uint32_t q16[11];
+
+    emit_label("q16_golden_rows", 4);
+    printf("    .4byte %u\n", Q16_GOLDEN_ROWS);
+    emit_label("q16_golden", 4);
+    for (uint32_t i = 0; i < Q16_GOLDEN_ROWS; i++) {
+        if (i < q16_edges) {
+            const int32_t *e = q16_edge[i];
+
+            q16_row(q16, e[0], e[1], e[2], e[3], e[4]);
+        }
+        else {
+            uint32_t x = gen_log_uniform();
+            int32_t xs = gen_signed(), a = gen_signed();
+            int32_t y = gen_signed(), x2 = gen_signed();
+
+            q16_row(q16, x ? x : 1, xs, a, y, x2);
+        }
+        for (int k = 0; k < 11; k++)
+            printf("%s0x%08x", k ? ", " : "    .4byte ", q16[k]);
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+/* Host-side generator for the lookup tables used by bfloat16.S,
+ * bf16_math.S and q16.c.
+ *
+ * Both tables are indexed by (exponent & 1) << 7 | mantissa, i.e. by the
+ * low bit of the biased exponent and the 7 stored mantissa bits of a
+ * normal, positive bf16 value. Each entry is added to (base << 7) by the
+ * kernel, so a carry into the exponent field is part of the entry.
+ *
+ *   bf16_sqrt_table   unsigned, base = (exp + 127) >> 1. Reproduces the
+ *                     binary search the old my_sqrt ran over my_mul.
+ *   bf16_rsqrt_table  signed, base = 254 - ((exp + 127) >> 1). Correctly
+ *                     rounded (RNE) 1/sqrt(x).
+ *
+ * The bf16_math.S tables are indexed by the 7 mantissa bits alone, or
+ * hold knots for linear interpolation; word tables are fixed point:
+ *
+ *   bf16_recip_table   signed bytes, correctly rounded 1/(1 + m/128) as an
+ *                      offset from (254 - exp) << 7, like bf16_rsqrt_table
+ *   bf16_exp_table     (1 + m/128) * log2(e), Q22
+ *   bf16_log2_table    log2(1 + m/128), Q22
+ *   bf16_exp2_knots    2^(i/64) for i = 0..64, Q23
+ *   bf16_recip_knots   1/(1 + i/64) for i = 0..65, Q24 (the last knot is
+ *                      only ever weighted by 0)
+ *
+ * q16.c:
+ *
+ *   q16_rsqrt_knots    1/sqrt(f) for f = 2^o * (1 + j/64), o = 0, 1 and
+ *                      j = 0..64, Q31
+ *   q16_cordic_atan    atan(2^-i) for i = 0..23, Q29
+ *   q16_cordic_gain    prod(i < n) 1/sqrt(1 + 2^-2i) for n = 0..24, Q29
+ *
+ * Usage: bf16_tablegen > bf16_tables.S
+ */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+static int sqrt_entry(int exp, int mant)
+{
+    int e = exp - 127;
+    int m = mant | 0x80;
+    int low = 90, high = 256, result = 128;
+
+    if (e & 1)
+        m <<= 1;
+    while (low <= high) {
+        int mid = (low + high) >> 1;
+        int sq = (mid * mid) >> 7;
+
+        result = mid;
+        if (m < sq)
+            high = mid - 1;
+        else
+            low = mid + 1;
+    }
+    if (result >= 256)
+        return 0x80 | ((result >> 1) & 0x7F);
+    return result & 0x7F;
+}
+
+static int rsqrt_entry(int exp, int mant)
+{
+    double x = ldexp(1.0 + mant / 128.0, exp - 127);
+    int k;
+    double f = frexp(1.0 / sqrt(x), &k); /* f in [0.5, 1) */
+    int sig = (int) nearbyint(f * 256.0);  /* 8 significant bits */
+    int bits;
+
+    if (sig == 256) {
+        sig = 128;
+        k++;
+    }
+    bits = ((k - 1 + 127) << 7) | (sig & 0x7F);
+    return bits - ((254 - ((exp + 127) >> 1)) << 7);
+}
+
+static void emit(const char *name, int (*entry)(int, int))
+{
+    printf(".globl %s\n%s:\n", name, name);
+    for (int i = 0; i < 256; i++) {
+        /* exp 128 and 127 stand for every even and odd biased exponent */
+        int v = entry((i & 0x80) ? 127 : 128, i & 0x7F);
+
+        printf("%s%d", (i & 15) ? ", " : "    .byte  ", v);
+        if ((i & 15) == 15)
+            printf("\n");
+    }
+    printf("\n");
+}
+
+static int recip_entry(int mant)
+{
+    int k;
+    double f = frexp(1.0 / (1.0 + mant / 128.0), &k); /* f in [0.5, 1) */
+    int sig = (int) nearbyint(f * 256.0);
+    int bits;
+
+    if (sig == 256) {
+        sig = 128;
+        k++;
+    }
+    bits = ((k - 1 + 127) << 7) | (sig & 0x7F);
+    return bits - (127 << 7);
+}
+
+static void emit_bytes(const char *name, int (*entry)(int), int n)
+{
+    printf(".globl %s\n%s:\n", name, name);
+    for (int i = 0; i < n; i++) {
+        printf("%s%d", (i & 15) ? ", " : "    .byte  ", entry(i));
+        if ((i & 15) == 15 || i == n - 1)
+            printf("\n");
+    }
+    printf("\n");
+}
+
+static void emit_words(const char *name, double (*f)(int), int frac, int n)
+{
+    printf(".balign 4\n.globl %s\n%s:\n", name, name);
+    for (int i = 0; i < n; i++) {
+        long v = lrint(ldexp(f(i), frac));
+
+        printf("%s%ld", (i & 7) ? ", " : "    .4byte ", v);
+        if ((i & 7) == 7 || i == n - 1)
+            printf("\n");
+    }
+    printf("\n");
+}
+
+static double exp_entry(int mant)
+{
+    return (1.0 + mant / 128.0) / log(2.0);
+}
+
+static double log2_entry(int mant)
+{
+    return log2(1.0 + mant / 128.0);
+}
+
+static double exp2_knot(int i)
+{
+    return exp2(i / 64.0);
+}
+
+static double recip_knot(int i)
+{
+    return 1.0 / (1.0 + i / 64.0);
+}
+
+static double rsqrt_knot(int i)
+{
+    return 1.0 / sqrt((i > 64 ? 2.0 : 1.0) * (1.0 + (i % 65) / 64.0));
+}
+
+static double cordic_atan(int i)
+{
+    return atan(ldexp(1.0, -i));
+}
+
+static double cordic_gain(int n)
+{
+    double k = 1.0;
+
+    for (int i = 0; i < n; i++)
+        k /= sqrt(1.0 + ldexp(1.0, -2 * i));
+    return k;
+}
+
+int main(void)
+{
+    printf("# Generated by bf16_tablegen.c, do not edit.\n");
+    printf(".section .rodata\n\n");
+    emit("bf16_sqrt_table", sqrt_entry);
+    emit("bf16_rsqrt_table", rsqrt_entry);
+    emit_bytes("bf16_recip_table", recip_entry, 128);
+    emit_words("bf16_exp_table", exp_entry, 22, 128);
+    emit_words("bf16_log2_table", log2_entry, 22, 128);
+    emit_words("bf16_exp2_knots", exp2_knot, 23, 65);
+    emit_words("bf16_recip_knots", recip_knot, 24, 66);
+    emit_words("q16_rsqrt_knots", rsqrt_knot, 31, 130);
+    emit_words("q16_cordic_atan", cordic_atan, 29, 24);
+    emit_words("q16_cordic_gain", cordic_gain, 29, 25);
+    return 0;
+}
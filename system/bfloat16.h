@@ -0,0 +1,284 @@
+#ifndef BFLOAT16_H
+#define BFLOAT16_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Assembly kernels (bfloat16.S, bf16_spec.S, bf16_fma.S, bf16_linalg.S,
+ * bf16_math.S, bf16x2.S, common.S, hanoi.S, hero.S). portable/ has a C
+ * twin of every function here, bit-exact with the assembly, for native
+ * host builds (make host).
+ */
+
+typedef struct {
+    uint16_t bits;
+} bf16_t;
+
+/* Two bf16 values in one word, element 0 in the low half: the memory
+ * layout of a uint16_t pair on little-endian RV32, at half the footprint
+ * of f32 storage.
+ */
+typedef struct {
+    uint32_t bits;
+} bf16x2_t;
+
+static inline bf16x2_t bf16x2_pack(const bf16_t lo, const bf16_t hi)
+{
+    bf16x2_t v = {(uint32_t) lo.bits | (uint32_t) hi.bits << 16};
+    return v;
+}
+
+static inline bf16_t bf16x2_get(const bf16x2_t v, const unsigned i)
+{
+    bf16_t r = {(uint16_t) (v.bits >> (i ? 16 : 0))};
+    return r;
+}
+
+/* common.S */
+extern uint32_t my_mul(
+    const uint32_t in1,
+    const uint32_t in2,
+    const uint32_t reserv1,
+    const uint32_t reserv2,
+    const uint32_t reserv3,
+    const uint32_t reserv4,
+    const uint32_t reserv5,
+    uint32_t *out2
+);
+
+extern uint32_t my_clz(
+    const uint32_t in
+);
+
+/* bfloat16.S */
+extern uint16_t f32_to_bf16(const uint32_t in);
+extern uint32_t bf16_to_f32(const uint16_t in);
+
+extern bool is_inf(
+    const uint32_t in,
+    const uint32_t reserv1,
+    const uint32_t reserv2,
+    const uint32_t mant_offset,
+    const uint32_t exp_offset
+);
+extern bool is_nan(
+    const uint32_t in,
+    const uint32_t reserv1,
+    const uint32_t reserv2,
+    const uint32_t mant_offset,
+    const uint32_t exp_offset
+);
+extern bool is_zero(
+    const uint32_t in,
+    const uint32_t reserv1,
+    const uint32_t reserv2,
+    const uint32_t mant_exp_offset
+);
+
+extern bool is_eq(
+    const uint32_t in1,
+    const uint32_t in2,
+    const uint32_t reserv,
+    const uint32_t mant_offset,
+    const uint32_t exp_offset,
+    const uint32_t sign_offset
+);
+
+extern bool is_lt(
+    const uint32_t in1,
+    const uint32_t in2,
+    const uint32_t reserv,
+    const uint32_t mant_offset,
+    const uint32_t exp_offset,
+    const uint32_t sign_offset
+);
+
+extern bool is_gt(
+    const uint32_t in1,
+    const uint32_t in2,
+    const uint32_t reserv,
+    const uint32_t mant_offset,
+    const uint32_t exp_offset,
+    const uint32_t sign_offset
+);
+
+extern uint32_t my_add(
+    const uint32_t in1,
+    const uint32_t in2,
+    const uint32_t reserv,
+    const uint32_t mant_offset,
+    const uint32_t exp_offset,
+    const uint32_t sign_offset
+);
+
+extern uint32_t my_sub(
+    const uint32_t in1,
+    const uint32_t in2,
+    const uint32_t reserv,
+    const uint32_t mant_offset,
+    const uint32_t exp_offset,
+    const uint32_t sign_offset
+);
+
+extern uint32_t my_fp_mul(
+    const uint32_t in1,
+    const uint32_t in2,
+    const uint32_t reserv,
+    const uint32_t mant_offset,
+    const uint32_t exp_offset,
+    const uint32_t sign_offset,
+    const uint32_t oper_offset
+);
+
+extern uint32_t my_div(
+    const uint32_t in1,
+    const uint32_t in2,
+    const uint32_t reserv,
+    const uint32_t mant_offset,
+    const uint32_t exp_offset,
+    const uint32_t sign_offset,
+    const uint32_t oper_offset
+);
+
+/* my_div with the table-seeded reciprocal engine (bf16 layout only) */
+extern uint32_t my_div_recip(
+    const uint32_t in1,
+    const uint32_t in2,
+    const uint32_t reserv,
+    const uint32_t mant_offset,
+    const uint32_t exp_offset,
+    const uint32_t sign_offset,
+    const uint32_t oper_offset
+);
+
+extern uint32_t my_sqrt(
+    const uint32_t in
+);
+
+/* bf16 sibling of fast_rsqrt, table lookup (bf16_tablegen.c) */
+extern uint32_t bf16_rsqrt(
+    const uint32_t in
+);
+
+/* Format-specialized kernels (bf16_spec.S), immediate offsets */
+extern bool bf16_is_nan(const uint32_t in);
+extern bool bf16_is_inf(const uint32_t in);
+extern bool bf16_is_zero(const uint32_t in);
+extern bool bf16_eq(const uint32_t in1, const uint32_t in2);
+extern bool bf16_lt(const uint32_t in1, const uint32_t in2);
+extern bool bf16_gt(const uint32_t in1, const uint32_t in2);
+extern uint32_t bf16_add(const uint32_t in1, const uint32_t in2);
+extern uint32_t bf16_sub(const uint32_t in1, const uint32_t in2);
+extern uint32_t bf16_mul(const uint32_t in1, const uint32_t in2);
+extern uint32_t bf16_div(const uint32_t in1, const uint32_t in2);
+
+extern bool f32_is_nan(const uint32_t in);
+extern bool f32_is_inf(const uint32_t in);
+extern bool f32_is_zero(const uint32_t in);
+extern bool f32_eq(const uint32_t in1, const uint32_t in2);
+extern bool f32_lt(const uint32_t in1, const uint32_t in2);
+extern bool f32_gt(const uint32_t in1, const uint32_t in2);
+extern uint32_t f32_add(const uint32_t in1, const uint32_t in2);
+extern uint32_t f32_sub(const uint32_t in1, const uint32_t in2);
+extern uint32_t f32_mul(const uint32_t in1, const uint32_t in2);
+extern uint32_t f32_div(const uint32_t in1, const uint32_t in2);
+
+/* Fused multiply-add (bf16_fma.S): a*b + c and a*b - c from the whole
+ * mantissa product, rounded once to nearest even, where bf16_mul followed
+ * by bf16_add truncates twice. Subnormals are kept.
+ */
+extern uint32_t bf16_fma(const uint32_t in1, const uint32_t in2,
+                         const uint32_t in3);
+extern uint32_t bf16_fms(const uint32_t in1, const uint32_t in2,
+                         const uint32_t in3);
+
+/* Linear algebra over bf16 with f32 accumulation (bf16_linalg.S).
+ * bf16_mul_f32 widens a product exactly (16 mantissa bits fit in f32),
+ * f32_add accumulates in index order from +0, so each output is the same
+ * bits as the plain loop. Matrices are row-major: gemv is y (m) = A (m x n)
+ * x (n), gemm is C (m x n) = A (m x k) B (k x n); y and C are f32.
+ */
+extern uint32_t bf16_mul_f32(const uint32_t in1, const uint32_t in2);
+extern uint32_t bf16_dot(const uint16_t *x, const uint16_t *y, uint32_t n);
+extern void bf16_gemv(uint32_t *y, const uint16_t *a, const uint16_t *x,
+                      uint32_t m, uint32_t n);
+extern void bf16_gemm(uint32_t *c, const uint16_t *a, const uint16_t *b,
+                      uint32_t m, uint32_t n, uint32_t k);
+
+/* Transcendentals (bf16_math.S) from bf16_tablegen.c tables. exp, sigmoid
+ * and tanh interpolate between knots, one multiply per step, and are
+ * within 1 ulp; log2 and recip are correctly rounded lookups. Subnormal
+ * inputs count as zero, subnormal results flush to zero; log2 of a
+ * negative number is NaN, of zero -inf.
+ */
+extern uint32_t bf16_exp(const uint32_t in);
+extern uint32_t bf16_log2(const uint32_t in);
+extern uint32_t bf16_sigmoid(const uint32_t in);
+extern uint32_t bf16_tanh(const uint32_t in);
+extern uint32_t bf16_recip(const uint32_t in);
+
+/* Array kernels: dst[i] = a[i] op b[i] for i < n, packed bf16 */
+extern void bf16_add_n(uint16_t *dst, const uint16_t *a, const uint16_t *b,
+                       uint32_t n);
+extern void bf16_sub_n(uint16_t *dst, const uint16_t *a, const uint16_t *b,
+                       uint32_t n);
+extern void bf16_mul_n(uint16_t *dst, const uint16_t *a, const uint16_t *b,
+                       uint32_t n);
+extern void bf16_div_n(uint16_t *dst, const uint16_t *a, const uint16_t *b,
+                       uint32_t n);
+extern void bf16_sqrt_n(uint16_t *dst, const uint16_t *a, uint32_t n);
+extern void bf16_exp_n(uint16_t *dst, const uint16_t *a, uint32_t n);
+extern void bf16_log2_n(uint16_t *dst, const uint16_t *a, uint32_t n);
+extern void bf16_sigmoid_n(uint16_t *dst, const uint16_t *a, uint32_t n);
+extern void bf16_tanh_n(uint16_t *dst, const uint16_t *a, uint32_t n);
+extern void bf16_recip_n(uint16_t *dst, const uint16_t *a, uint32_t n);
+
+/* Streaming conversion of n values between f32 and packed bf16: round to
+ * nearest even like f32_to_bf16, but NaNs are quieted rather than
+ * truncated. An odd tail touches only the low half of the last word.
+ */
+extern void f32_to_bf16_n(bf16x2_t *dst, const uint32_t *src, uint32_t n);
+extern void bf16_to_f32_n(uint32_t *dst, const bf16x2_t *src, uint32_t n);
+
+/* Packed bf16x2 kernels (bf16x2.S), both lanes per call, branchless.
+ * Predicates return 0xFFFF in each lane where they hold. Compares are
+ * IEEE: NaN lanes compare false and -0 == +0, unlike is_lt, which is
+ * true for equal negatives and for inf < inf. min/max order -0 below +0
+ * and return the other operand for a NaN lane.
+ */
+extern bf16x2_t bf16x2_is_nan(const bf16x2_t in);
+extern bf16x2_t bf16x2_is_inf(const bf16x2_t in);
+extern bf16x2_t bf16x2_is_zero(const bf16x2_t in);
+extern bf16x2_t bf16x2_eq(const bf16x2_t in1, const bf16x2_t in2);
+extern bf16x2_t bf16x2_lt(const bf16x2_t in1, const bf16x2_t in2);
+extern bf16x2_t bf16x2_gt(const bf16x2_t in1, const bf16x2_t in2);
+extern bf16x2_t bf16x2_min(const bf16x2_t in1, const bf16x2_t in2);
+extern bf16x2_t bf16x2_max(const bf16x2_t in1, const bf16x2_t in2);
+extern bf16x2_t bf16x2_abs(const bf16x2_t in);
+extern bf16x2_t bf16x2_neg(const bf16x2_t in);
+extern bf16x2_t bf16x2_copysign(const bf16x2_t mag, const bf16x2_t sign);
+
+/* Towers of Hanoi (hanoi.S), A to C, 0..HANOI_MAX_DISKS disks (more are
+ * clamped). hanoi prints every move; hanoi_checksum runs the same engine
+ * without output and returns the rotate-xor (sum = rotl(sum, 5) ^ move)
+ * of all move words. hanoi_move gives move k (1 <= k < 2^num) of a num-disk
+ * tower directly from its index, 0 outside that range. A move word is
+ * disk << 16 | from << 8 | to, disks from 1, pegs A/B/C as 0/1/2.
+ */
+#define HANOI_MAX_DISKS 31
+
+extern void hanoi(int num);
+extern uint32_t hanoi_checksum(int num);
+extern uint32_t hanoi_move(uint32_t num, uint32_t k);
+
+extern uint32_t hero(
+    const bf16_t a,
+    const bf16_t b,
+    const bf16_t c
+);
+
+/* out[i] = hero(a[i], b[i], c[i]) over structure-of-arrays triangles */
+extern void hero_n(uint16_t *out, const uint16_t *a, const uint16_t *b,
+                   const uint16_t *c, uint32_t n);
+
+#endif /* BFLOAT16_H */
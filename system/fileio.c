@@ -0,0 +1,186 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef HOST_BUILD
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "arena.h"
+#include "fileio.h"
+
+#ifndef HOST_BUILD
+#define SYS_CLOSE 57
+#define SYS_READ 63
+#define SYS_WRITE 64
+#define SYS_OPEN 1024
+
+/* newlib flag bits; the emulator maps the access mode to an fopen mode */
+#define FIO_O_CREAT 0x200
+#define FIO_O_TRUNC 0x400
+
+static long fio_syscall(long nr, long a0, long a1, long a2)
+{
+    register long r_a0 asm("a0") = a0;
+    register long r_a1 asm("a1") = a1;
+    register long r_a2 asm("a2") = a2;
+    register long r_a7 asm("a7") = nr;
+
+    asm volatile("ecall"
+                 : "+r"(r_a0)
+                 : "r"(r_a1), "r"(r_a2), "r"(r_a7)
+                 : "memory");
+    return r_a0;
+}
+#endif
+
+int fio_open(const char *path, int mode)
+{
+#ifdef HOST_BUILD
+    if (mode == FIO_WRITE)
+        return open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    return open(path, O_RDONLY);
+#else
+    long flags = (mode == FIO_WRITE) ? 1 | FIO_O_CREAT | FIO_O_TRUNC : 0;
+
+    return fio_syscall(SYS_OPEN, (long) path, flags, 0644);
+#endif
+}
+
+long fio_read(int fd, void *buf, size_t n)
+{
+#ifdef HOST_BUILD
+    return read(fd, buf, n);
+#else
+    return fio_syscall(SYS_READ, fd, (long) buf, n);
+#endif
+}
+
+long fio_write(int fd, const void *buf, size_t n)
+{
+#ifdef HOST_BUILD
+    return write(fd, buf, n);
+#else
+    return fio_syscall(SYS_WRITE, fd, (long) buf, n);
+#endif
+}
+
+int fio_close(int fd)
+{
+#ifdef HOST_BUILD
+    return close(fd);
+#else
+    return fio_syscall(SYS_CLOSE, fd, 0, 0);
+#endif
+}
+
+int fio_reader_init(struct fio_reader *r, int fd, struct arena *a,
+                    size_t cap, size_t rec_size)
+{
+    size_t mark = arena_mark(a);
+    unsigned shift = 0;
+
+    if (rec_size == 0 || (rec_size & (rec_size - 1)) || cap < rec_size)
+        return -1;
+    while ((1u << shift) != rec_size)
+        shift++;
+    r->buf[0] = arena_alloc(a, cap);
+    r->buf[1] = arena_alloc(a, cap);
+    if (!r->buf[0] || !r->buf[1]) {
+        arena_reset(a, mark);
+        return -1;
+    }
+    r->fd = fd;
+    r->cap = cap;
+    r->rec_size = rec_size;
+    r->rec_shift = shift;
+    r->carry = 0;
+    r->cur = 0;
+    r->eof = 0;
+    r->reads = 0;
+    r->bytes = 0;
+    return 0;
+}
+
+/* Fill buf[cur] behind the carried bytes until it holds at least one
+ * record or the file ends; short reads are retried. */
+const void *fio_reader_next(struct fio_reader *r, uint32_t *n)
+{
+    uint8_t *buf = r->buf[r->cur], *next = r->buf[r->cur ^ 1];
+    size_t len = r->carry, whole;
+
+    while (!r->eof && len < r->cap) {
+        long got = fio_read(r->fd, buf + len, r->cap - len);
+
+        r->reads++;
+        if (got <= 0) {
+            r->eof = 1;
+            break;
+        }
+        len += got;
+        r->bytes += got;
+        if (len >= r->rec_size)
+            break;
+    }
+    whole = len & ~(r->rec_size - 1);
+    *n = whole >> r->rec_shift;
+    if (whole == 0) {
+        r->carry = 0;
+        return NULL;
+    }
+    /* the cut record opens the other buffer */
+    r->carry = len - whole;
+    memcpy(next, buf + whole, r->carry);
+    r->cur ^= 1;
+    return buf;
+}
+
+int fio_writer_init(struct fio_writer *w, int fd, struct arena *a,
+                    size_t cap)
+{
+    if (cap == 0)
+        return -1;
+    w->buf = arena_alloc(a, cap);
+    if (!w->buf)
+        return -1;
+    w->fd = fd;
+    w->cap = cap;
+    w->len = 0;
+    w->writes = 0;
+    w->bytes = 0;
+    return 0;
+}
+
+int fio_writer_flush(struct fio_writer *w)
+{
+    size_t done = 0;
+
+    while (done < w->len) {
+        long n = fio_write(w->fd, w->buf + done, w->len - done);
+
+        w->writes++;
+        if (n <= 0)
+            return -1;
+        done += n;
+    }
+    w->bytes += w->len;
+    w->len = 0;
+    return 0;
+}
+
+int fio_writer_put(struct fio_writer *w, const void *data, size_t n)
+{
+    const uint8_t *p = data;
+
+    while (n) {
+        size_t room = w->cap - w->len, k = (n < room) ? n : room;
+
+        memcpy(w->buf + w->len, p, k);
+        w->len += k;
+        p += k;
+        n -= k;
+        if (w->len == w->cap && fio_writer_flush(w))
+            return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+#ifndef FILEIO_H
+#define FILEIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+
+/* File streaming through the emulator's newlib-style syscalls (fileio.c):
+ * open (1024), read (63), write (64) and close (57), POSIX calls on host
+ * builds. Paths are relative to where the emulator runs.
+ *
+ * fio_reader hands out input in chunks of whole fixed-size records. It
+ * owns two buffers from an arena and refills them alternately: a record
+ * cut by the end of one read is moved to the front of the other buffer
+ * and completed by the next read, and the chunk returned last stays valid
+ * while the next one is read. fio_writer collects output in one buffer
+ * and writes it when full and on fio_writer_flush.
+ */
+
+#define FIO_READ 0  /* O_RDONLY */
+#define FIO_WRITE 1 /* O_WRONLY, created or truncated */
+
+/* file descriptor, or negative on failure */
+int fio_open(const char *path, int mode);
+/* bytes moved, 0 at end of file, negative on failure */
+long fio_read(int fd, void *buf, size_t n);
+long fio_write(int fd, const void *buf, size_t n);
+int fio_close(int fd);
+
+struct fio_reader {
+    int fd;
+    uint8_t *buf[2];
+    size_t cap;      /* bytes per buffer */
+    size_t rec_size; /* bytes per record, a power of two */
+    unsigned rec_shift;
+    size_t carry;    /* bytes of a cut record, at the front of buf[cur] */
+    unsigned cur;    /* buffer the next read fills */
+    int eof;
+    uint32_t reads;  /* read syscalls issued */
+    uint64_t bytes;  /* bytes read */
+};
+
+struct fio_writer {
+    int fd;
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    uint32_t writes; /* write syscalls issued */
+    uint64_t bytes;  /* bytes written */
+};
+
+/* Both take their buffers from 'a', cap bytes each; -1 and nothing
+ * allocated when it is too small. The reader needs cap >= rec_size and a
+ * power-of-two rec_size (no division on RV32I). */
+int fio_reader_init(struct fio_reader *r, int fd, struct arena *a,
+                    size_t cap, size_t rec_size);
+int fio_writer_init(struct fio_writer *w, int fd, struct arena *a,
+                    size_t cap);
+
+/* The next chunk and its record count in *n; NULL with *n = 0 at end of
+ * file. A trailing partial record is dropped. */
+const void *fio_reader_next(struct fio_reader *r, uint32_t *n);
+
+/* 0, or -1 when a write failed */
+int fio_writer_put(struct fio_writer *w, const void *data, size_t n);
+int fio_writer_flush(struct fio_writer *w);
+
+#endif /* FILEIO_H */
@@ -0,0 +1,134 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fmt.h"
+
+static const char fmt_digits2[200] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/* Returns *v / d and leaves *v % d, for a quotient below 2^bits. Restoring
+ * division against d << k, so the loop runs 'bits' times instead of 32.
+ */
+static uint32_t divmod32(uint32_t *v, uint32_t d, int bits)
+{
+    uint32_t q = 0, r = *v;
+
+    for (int k = bits - 1; k >= 0; k--) {
+        q <<= 1;
+        if (r >= (d << k)) {
+            r -= d << k;
+            q |= 1;
+        }
+    }
+    *v = r;
+    return q;
+}
+
+/* 64-bit variant for 10^8 only: the quotient of any uint64_t is below
+ * 2^38, and 10^8 << 37 still fits.
+ */
+static uint64_t divmod_1e8(uint64_t *v)
+{
+    uint64_t q = 0, r = *v, d = (uint64_t) 100000000 << 37;
+
+    for (int k = 0; k < 38; k++) {
+        q <<= 1;
+        if (r >= d) {
+            r -= d;
+            q |= 1;
+        }
+        d >>= 1;
+    }
+    *v = r;
+    return q;
+}
+
+/* Four digits of x < 10^4 */
+static void put4(char *p, uint32_t x)
+{
+    uint32_t hi = divmod32(&x, 100, 7);
+
+    p[0] = fmt_digits2[2 * hi];
+    p[1] = fmt_digits2[2 * hi + 1];
+    p[2] = fmt_digits2[2 * x];
+    p[3] = fmt_digits2[2 * x + 1];
+}
+
+size_t fmt_u64(char *buf, uint64_t val, unsigned width, unsigned flags)
+{
+    char digits[24];
+    char *p = digits + sizeof(digits);
+    uint32_t part[3]; /* base-10^8 limbs, most significant first */
+    size_t ndig, len, commas = 0;
+    unsigned left;
+    char *o = buf;
+
+    if (val >> 32) {
+        uint64_t q = divmod_1e8(&val);
+
+        part[2] = (uint32_t) val;
+        if (q >> 32) {
+            part[0] = (uint32_t) divmod_1e8(&q);
+            part[1] = (uint32_t) q;
+        } else {
+            uint32_t r = (uint32_t) q;
+
+            part[0] = divmod32(&r, 100000000, 6);
+            part[1] = r;
+        }
+    } else {
+        uint32_t r = (uint32_t) val;
+
+        part[0] = 0;
+        part[1] = divmod32(&r, 100000000, 6);
+        part[2] = r;
+    }
+
+    /* Right to left; limbs above the most significant one are skipped */
+    int first = part[0] ? 0 : (part[1] ? 1 : 2);
+    for (int i = 2; i >= first; i--) {
+        uint32_t x = part[i];
+        uint32_t hi = divmod32(&x, 10000, 14);
+
+        p -= 4;
+        put4(p, x);
+        if (i != first || hi) {
+            p -= 4;
+            put4(p, hi);
+        }
+    }
+    while (p < digits + sizeof(digits) - 1 && *p == '0')
+        p++;
+    ndig = digits + sizeof(digits) - p;
+
+    /* Digits in the leading group, 1..3 */
+    left = ndig;
+    while (left > 3) {
+        left -= 3;
+        commas++;
+    }
+    len = ndig;
+    if (flags & FMT_COMMA)
+        len += commas;
+
+    if (width > FMT_U64_MAX)
+        width = FMT_U64_MAX;
+    while (len < width) {
+        *o++ = (flags & FMT_ZERO) ? '0' : ' ';
+        width--;
+    }
+
+    for (size_t i = 0; i < ndig; i++) {
+        *o++ = p[i];
+        if (--left == 0 && i + 1 < ndig) {
+            if (flags & FMT_COMMA)
+                *o++ = ',';
+            left = 3;
+        }
+    }
+    return o - buf;
+}
@@ -0,0 +1,27 @@
+#ifndef FMT_H
+#define FMT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Decimal formatting of full 64-bit values (fmt.c) by short restoring
+ * division: the value splits into base-10^8 limbs (38 steps, or 6 once
+ * the rest fits in 32 bits), each limb into 10^4 halves (14 steps) and
+ * each half into 100s (7 steps). Every step is a shift-subtract against
+ * the pre-shifted divisor, one per quotient bit, rather than a 32-step
+ * udiv/umod; two digits at a time from a lookup table.
+ */
+
+/* Output buffer size for fmt_u64: 20 digits + 6 commas, padded up */
+#define FMT_U64_MAX 32
+
+#define FMT_COMMA 0x1 /* group thousands: 1,234,567 */
+#define FMT_ZERO 0x2  /* pad the field with '0' instead of ' ' */
+
+/* Writes val into buf right-aligned in a field of at least 'width'
+ * characters (capped at FMT_U64_MAX) and returns the length.
+ * No terminating NUL is written.
+ */
+size_t fmt_u64(char *buf, uint64_t val, unsigned width, unsigned flags);
+
+#endif /* FMT_H */
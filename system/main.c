@@ -2,20 +2,16 @@
 #include <stdint.h>
 #include <string.h>
 
-#define printstr(ptr, length)                   \
-    do {                                        \
-        asm volatile(                           \
-            "li a7, 0x40;"                 \
-            "li a0, 0x1;" /* stdout */     \
-            "mv a1, %0;"                   \
-            "mv a2, %1;" /* length character */ \
-            "ecall;"                            \
-            :                                   \
-            : "r"(ptr), "r"(length)             \
-            : "a0", "a1", "a2", "a7");          \
-    } while (0)
+#include "arena.h"
+#include "bench.h"
+#include "bfloat16.h"
+#include "fileio.h"
+#include "fmt.h"
+#include "output.h"
+#include "q16.h"
+#include "trace.h"
 
-#define TEST_OUTPUT(msg, length) printstr(msg, length)
+#define TEST_OUTPUT(msg, length) out_write(msg, length)
 
 #define TEST_LOGGER(msg)                     \
     {                                        \
@@ -26,22 +22,16 @@
 extern uint64_t get_cycles(void);
 extern uint64_t get_instret(void);
 
-/* Bare metal memcpy implementation */
-void *memcpy(void *dest, const void *src, size_t n)
-{
-    uint8_t *d = (uint8_t *) dest;
-    const uint8_t *s = (const uint8_t *) src;
-    while (n--)
-        *d++ = *s++;
-    return dest;
-}
-
-/* Software division for RV32I (no M extension) */
+/* Software division for RV32I (no M extension), divu when there is one;
+ * host builds, where unsigned long may be 64-bit, divide natively */
 static unsigned long udiv(unsigned long dividend, unsigned long divisor)
 {
     if (divisor == 0)
         return 0;
 
+#if defined(__riscv_div) || defined(HOST_BUILD)
+    return dividend / divisor;
+#else
     unsigned long quotient = 0;
     unsigned long remainder = 0;
 
@@ -56,298 +46,98 @@ static unsigned long udiv(unsigned long dividend, unsigned long divisor)
     }
 
     return quotient;
+#endif
 }
 
-static unsigned long umod(unsigned long dividend, unsigned long divisor)
-{
-    if (divisor == 0)
-        return 0;
-
-    unsigned long remainder = 0;
-
-    for (int i = 31; i >= 0; i--) {
-        remainder <<= 1;
-        remainder |= (dividend >> i) & 1;
+typedef union {
+    uint64_t whole;
+    uint32_t part[2];
+} my_uint64_t;
 
-        if (remainder >= divisor) {
-            remainder -= divisor;
-        }
+/* Bit-serial shift-add multiply, kept as the baseline for test_mul_bench */
+static uint64_t mul32_bitserial(uint32_t a, uint32_t b)
+{
+    uint64_t r = 0;
+    for (int i = 0; i < 32; i++) {
+        if (b & (1u << i))
+            r += (uint64_t) a << i;
     }
+    return r;
+}
 
-    return remainder;
+static uint64_t mul32(uint32_t a, uint32_t b)
+{
+    my_uint64_t r;
+    r.part[0] = my_mul(a, b, 0, 0, 0, 0, 0, &r.part[1]);
+    return r.whole;
 }
 
+#if !defined(HOST_BUILD) && !defined(__riscv_mul)
 /* Software multiplication for RV32I (no M extension) */
 static uint32_t umul(uint32_t a, uint32_t b)
 {
-    uint32_t result = 0;
-    while (b) {
-        if (b & 1)
-            result += a;
-        a <<= 1;
-        b >>= 1;
-    }
-    return result;
-}
-
-static uint64_t mul32(uint32_t a, uint32_t b) {
-    uint64_t r = 0;
-    for (int i = 0; i < 32; i++) {
-        if (b & (1u << i))
-            r+=(uint64_t) a << i;
-    }
-    return r;
+    uint32_t hi;
+    return my_mul(a, b, 0, 0, 0, 0, 0, &hi);
 }
 
 /* Provide __mulsi3 for GCC */
-uint32_t __mulsi3(uint32_t a, uint32_t b)
+__attribute__((used)) uint32_t __mulsi3(uint32_t a, uint32_t b)
 {
     return umul(a, b);
 }
-
-extern uint32_t my_mul(
-    const uint32_t in1,
-    const uint32_t in2,
-    const uint32_t reserv1,
-    const uint32_t reserv2,
-    const uint32_t reserv3,
-    const uint32_t reserv4,
-    const uint32_t reserv5,
-    uint32_t *out2
-);
-
-extern uint32_t my_clz(
-    const uint32_t in
-);
+#endif
 
 /* Simple integer to hex string conversion */
 static void print_hex(unsigned long val)
 {
-    char buf[20];
-    char *p = buf + sizeof(buf) - 1;
-    *p = '\n';
-    p--;
-
-    if (val == 0) {
-        *p = '0';
-        p--;
-    } else {
-        while (val > 0) {
-            int digit = val & 0xf;
-            *p = (digit < 10) ? ('0' + digit) : ('a' + digit - 10);
-            p--;
-            val >>= 4;
-        }
-    }
-
-    p++;
-    printstr(p, (buf + sizeof(buf) - p));
+    out_hex(val);
+    out_putc('\n');
 }
 
-/* Simple integer to decimal string conversion */
-static void print_dec(unsigned long val)
+/* Simple integer to decimal string conversion, followed by 'end' */
+static void print_dec_end(uint64_t val, char end)
 {
-    char buf[20];
-    char *p = buf + sizeof(buf) - 1;
-    *p = '\n';
-    p--;
-
-    if (val == 0) {
-        *p = '0';
-        p--;
-    } else {
-        while (val > 0) {
-            *p = '0' + umod(val, 10);
-            p--;
-            val = udiv(val, 10);
-        }
-    }
-
-    p++;
-    printstr(p, (buf + sizeof(buf) - p));
+    out_u64(val, 0, 0);
+    out_putc(end);
 }
 
-/* ============= fast reciprocal square root Implementation ============= */
-
-typedef union {
-    uint64_t whole;
-    uint32_t part[2];
-} my_uint64_t;
-
-static const uint16_t rsqrt_table[32] = {
-    65536, 46341, 32768, 23170, 16384,  /* 2^0 to 2^4 */
-    11585,  8192,  5793,  4096,  2896,  /* 2^5 to 2^9 */
-     2048,  1448,  1024,   724,   512,  /* 2^10 to 2^14 */
-      362,   256,   181,   128,    90,  /* 2^15 to 2^19 */
-       64,    45,    32,    23,    16,  /* 2^20 to 2^24 */
-       11,     8,     6,     4,     3,  /* 2^25 to 2^29 */
-        2,     1                         /* 2^30, 2^31 */
-};
-
-static inline unsigned clz(uint32_t x)
+static void print_dec(uint64_t val)
 {
-    int n = 32, c = 16;
-    do {
-        uint32_t y = x >> c;
-        if (y) {
-            n -= c;
-            x = y;
-        }
-        c >>= 1;
-    } while (c);
-    return n - x;
+    print_dec_end(val, '\n');
 }
 
+/* "  mismatches: N" then PASSED or FAILED, ending a check */
+static void report_mismatches(uint32_t n_bad)
+{
+    TEST_LOGGER("  mismatches: ");
+    print_dec_end(n_bad, '\t');
+    if (n_bad == 0) {
+        TEST_LOGGER("PASSED\n");
+    }
+    else {
+        TEST_LOGGER("FAILED\n");
+    }
+}
 
-uint32_t fast_rsqrt(uint32_t x)
+/* Test-data PRNG: one xorshift32 step, returns the new state */
+static uint32_t xorshift32(uint32_t *state)
 {
-    // scaling 2^16
-    /* Handle edge cases */
-    if (x==0) return 0xFFFFFFFF;
-    if (x==1) return 65536;
+    uint32_t x = *state;
 
-    int exp2 = 31-clz(x);
-    int exp = 31-my_clz(x);
-    
-    uint32_t y = rsqrt_table[exp];
-    
-    if (x > (1u << exp)) {
-        my_uint64_t tmp;
-        uint32_t y_next = (exp < 31) ? rsqrt_table[exp + 1] : 0;
-        uint32_t delta = y - y_next;
-        uint32_t frac = (uint32_t) ((((uint64_t)x - (1UL << exp)) << 16) >> exp);
-        // y -= (uint32_t) ((delta * frac) >> 16);
-        tmp.part[0] = my_mul(delta, frac, 0, 0, 0, 0, 0, &(tmp.part[1]));
-        y -= (uint32_t) (tmp.whole >> 16);
-    }
-    for (int i = 0; i < 2; i++) {
-        my_uint64_t tmp;
-        tmp.part[0] = my_mul(y, y, 0, 0, 0, 0, 0, &(tmp.part[1]));
-        tmp.part[0] = my_mul(x, tmp.part[0], 0, 0, 0, 0, 0, &(tmp.part[1]));
-        uint32_t xy2 = (uint32_t)(tmp.whole >> 16);
-        tmp.part[0] = my_mul(y, (3u << 16)- xy2, 0, 0, 0, 0, 0, &(tmp.part[1]));
-        y = (uint32_t)(tmp.whole>>17);
-        // uint32_t y2 = (uint32_t) mul32(y,y);
-        // uint32_t xy2 = (uint32_t)(mul32(x, y2) >> 16);
-        // y = (uint32_t)(mul32(y, (3u << 16)- xy2) >> 17);
-    }
-    return y;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
 }
 
-
 /* ============= BFloat16 Implementation ============= */
 
-typedef struct {
-    uint16_t bits;
-} bf16_t;
 typedef union f32{
     uint32_t bits;
     float value;
 }f32_t;
 
-/* ============= my bfloat16 Declaration ============= */
-
-extern uint16_t f32_to_bf16(const uint32_t in);
-extern uint32_t bf16_to_f32(const uint16_t in);
-
-extern bool is_inf(
-    const uint32_t in,
-    const uint32_t reserv1,
-    const uint32_t reserv2,
-    const uint32_t mant_offset,
-    const uint32_t exp_offset
-);
-extern bool is_nan(
-    const uint32_t in,
-    const uint32_t reserv1,
-    const uint32_t reserv2,
-    const uint32_t mant_offset,
-    const uint32_t exp_offset
-);
-extern bool is_zero(
-    const uint32_t in,
-    const uint32_t reserv1,
-    const uint32_t reserv2,
-    const uint32_t mant_exp_offset
-);
-
-extern bool is_eq(
-    const uint32_t in1,
-    const uint32_t in2,
-    const uint32_t reserv,
-    const uint32_t mant_offset,
-    const uint32_t exp_offset,
-    const uint32_t sign_offset
-);
-
-extern bool is_lt(
-    const uint32_t in1,
-    const uint32_t in2,
-    const uint32_t reserv,
-    const uint32_t mant_offset,
-    const uint32_t exp_offset,
-    const uint32_t sign_offset
-);
-
-extern bool is_gt(
-    const uint32_t in1,
-    const uint32_t in2,
-    const uint32_t reserv,
-    const uint32_t mant_offset,
-    const uint32_t exp_offset,
-    const uint32_t sign_offset
-);
-
-extern uint32_t my_add(
-    const uint32_t in1,
-    const uint32_t in2,
-    const uint32_t reserv,
-    const uint32_t mant_offset,
-    const uint32_t exp_offset,
-    const uint32_t sign_offset
-);
-
-extern uint32_t my_sub(
-    const uint32_t in1,
-    const uint32_t in2,
-    const uint32_t reserv,
-    const uint32_t mant_offset,
-    const uint32_t exp_offset,
-    const uint32_t sign_offset
-);
-
-extern uint32_t my_fp_mul(
-    const uint32_t in1,
-    const uint32_t in2,
-    const uint32_t reserv,
-    const uint32_t mant_offset,
-    const uint32_t exp_offset,
-    const uint32_t sign_offset,
-    const uint32_t oper_offset
-);
-
-extern uint32_t my_div(
-    const uint32_t in1,
-    const uint32_t in2,
-    const uint32_t reserv,
-    const uint32_t mant_offset,
-    const uint32_t exp_offset,
-    const uint32_t sign_offset,
-    const uint32_t oper_offset
-);
-
-extern uint32_t my_sqrt(
-    const uint32_t in
-);
-
-extern void hanoi(int num);
-
-extern uint32_t hero(
-    const bf16_t a,
-    const bf16_t b,
-    const bf16_t c
-);
-
 /* ============= Test Suite ============= */
 #define BF16_NAN() ((bf16_t) {.bits = 0x7FC0})
 #define BF16_ZERO() ((bf16_t) {.bits = 0x0000})
@@ -454,6 +244,36 @@ static void test_bf16_div(void) {
     else {
         TEST_LOGGER("bf16 FP Division \t\tFAILED (expected 0x3f0b)\n");
     }
+
+    /* Restoring vs reciprocal engine, in1 over every normal divisor
+     * mantissa in [1, 2) */
+    uint64_t start_cycles, restoring_cycles = 0, recip_cycles = 0;
+    bool same = true;
+    for (uint32_t mant = 0; mant < 128; mant++) {
+        uint32_t d = 0x3F80 | mant;
+        uint32_t q_restoring, q_recip;
+
+        start_cycles = get_cycles();
+        q_restoring = my_div(in1_bf.bits, d, 0, 25, 7, 15, 15);
+        restoring_cycles += get_cycles() - start_cycles;
+
+        start_cycles = get_cycles();
+        q_recip = my_div_recip(in1_bf.bits, d, 0, 25, 7, 15, 15);
+        recip_cycles += get_cycles() - start_cycles;
+
+        if (q_restoring != q_recip)
+            same = false;
+    }
+    TEST_LOGGER("  restoring: ");
+    print_dec_end(restoring_cycles >> 7, '\t');
+    TEST_LOGGER("reciprocal: ");
+    print_dec_end(recip_cycles >> 7, ' ');
+    TEST_LOGGER("cycles/div\n");
+    if (same) {
+        TEST_LOGGER("  reciprocal == restoring \tPASSED\n");
+    } else {
+        TEST_LOGGER("  reciprocal == restoring \tFAILED\n");
+    }
 }
 
 static void test_bf16_sqrt(void) {
@@ -565,262 +385,327 @@ static void test_bf16_GT(void) {
     }
 }
 
-static void test_my_bfloat16(void)
+/* Run 'call' once, storing its result and retired instruction count */
+#define MEASURE_INSTRET(res, instret, call)  \
+    do {                                     \
+        uint64_t _start = get_instret();     \
+        (res) = (call);                      \
+        (instret) = get_instret() - _start;  \
+    } while (0)
+
+static void spec_report(const char *name,
+                        uint32_t gen_res,
+                        uint64_t gen_instret,
+                        uint32_t spec_res,
+                        uint64_t spec_instret)
+{
+    TEST_LOGGER("  ");
+    TEST_OUTPUT(name, 10);
+    TEST_LOGGER("generic: ");
+    print_dec_end(gen_instret, '\t');
+    TEST_LOGGER("specialized: ");
+    if (gen_res == spec_res) {
+        print_dec(spec_instret);
+    }
+    else {
+        print_dec_end(spec_instret, '\t');
+        TEST_LOGGER("MISMATCH\n");
+    }
+}
+
+static void test_spec_kernels(void)
 {
-    uint64_t start_cycles, end_cycles, cycles_elapsed;
-    uint64_t start_instret, end_instret, instret_elapsed;
+    f32_t in1, in2;
+    uint32_t a, b, gen_res, spec_res;
+    uint64_t gen_instret, spec_instret;
+
+    TEST_LOGGER("Generic vs specialized (instructions per call)\n");
+
+    /* bf16 */
+    in1.value = 0.3f;
+    in2.value = 0.5f;
+    a = f32_to_bf16(in1.bits);
+    b = f32_to_bf16(in2.bits);
+    MEASURE_INSTRET(gen_res, gen_instret, my_add(a, b, 0, 25, 7, 15));
+    MEASURE_INSTRET(spec_res, spec_instret, bf16_add(a, b));
+    spec_report("bf16 add  ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, my_sub(a, b, 0, 25, 7, 15));
+    MEASURE_INSTRET(spec_res, spec_instret, bf16_sub(a, b));
+    spec_report("bf16 sub  ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, my_fp_mul(a, b, 0, 25, 7, 15, 15));
+    MEASURE_INSTRET(spec_res, spec_instret, bf16_mul(a, b));
+    spec_report("bf16 mul  ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, my_div(a, b, 0, 25, 7, 15, 15));
+    MEASURE_INSTRET(spec_res, spec_instret, bf16_div(a, b));
+    spec_report("bf16 div  ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, is_eq(a, b, 0, 25, 7, 15));
+    MEASURE_INSTRET(spec_res, spec_instret, bf16_eq(a, b));
+    spec_report("bf16 eq   ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, is_lt(a, b, 0, 25, 7, 15));
+    MEASURE_INSTRET(spec_res, spec_instret, bf16_lt(a, b));
+    spec_report("bf16 lt   ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, is_gt(a, b, 0, 25, 7, 15));
+    MEASURE_INSTRET(spec_res, spec_instret, bf16_gt(a, b));
+    spec_report("bf16 gt   ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, is_nan(a, 0, 0, 25, 7));
+    MEASURE_INSTRET(spec_res, spec_instret, bf16_is_nan(a));
+    spec_report("bf16 nan  ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, is_inf(a, 0, 0, 25, 7));
+    MEASURE_INSTRET(spec_res, spec_instret, bf16_is_inf(a));
+    spec_report("bf16 inf  ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, is_zero(a, 0, 0, 17));
+    MEASURE_INSTRET(spec_res, spec_instret, bf16_is_zero(a));
+    spec_report("bf16 zero ", gen_res, gen_instret, spec_res, spec_instret);
+
+    /* f32 */
+    a = in1.bits;
+    b = in2.bits;
+    MEASURE_INSTRET(gen_res, gen_instret, my_add(a, b, 0, 9, 23, 31));
+    MEASURE_INSTRET(spec_res, spec_instret, f32_add(a, b));
+    spec_report("f32 add   ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, my_sub(a, b, 0, 9, 23, 31));
+    MEASURE_INSTRET(spec_res, spec_instret, f32_sub(a, b));
+    spec_report("f32 sub   ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, my_fp_mul(a, b, 0, 9, 23, 31, 48));
+    MEASURE_INSTRET(spec_res, spec_instret, f32_mul(a, b));
+    spec_report("f32 mul   ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, my_div(a, b, 0, 9, 23, 31, 48));
+    MEASURE_INSTRET(spec_res, spec_instret, f32_div(a, b));
+    spec_report("f32 div   ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, is_eq(a, b, 0, 9, 23, 31));
+    MEASURE_INSTRET(spec_res, spec_instret, f32_eq(a, b));
+    spec_report("f32 eq    ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, is_lt(a, b, 0, 9, 23, 31));
+    MEASURE_INSTRET(spec_res, spec_instret, f32_lt(a, b));
+    spec_report("f32 lt    ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, is_gt(a, b, 0, 9, 23, 31));
+    MEASURE_INSTRET(spec_res, spec_instret, f32_gt(a, b));
+    spec_report("f32 gt    ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, is_nan(a, 0, 0, 9, 23));
+    MEASURE_INSTRET(spec_res, spec_instret, f32_is_nan(a));
+    spec_report("f32 nan   ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, is_inf(a, 0, 0, 9, 23));
+    MEASURE_INSTRET(spec_res, spec_instret, f32_is_inf(a));
+    spec_report("f32 inf   ", gen_res, gen_instret, spec_res, spec_instret);
+    MEASURE_INSTRET(gen_res, gen_instret, is_zero(a, 0, 0, 1));
+    MEASURE_INSTRET(spec_res, spec_instret, f32_is_zero(a));
+    spec_report("f32 zero  ", gen_res, gen_instret, spec_res, spec_instret);
+}
 
+static void test_my_bfloat16(void)
+{
     TEST_LOGGER("--------------------\n");
     TEST_LOGGER("Test: My bfloat16\n");
-    
-    f32_t in1, in2, out, rt;
-    bf16_t in1_bf, in2_bf, out_bf, expect;
-
-    
 
-    /* Addition */
-    start_cycles = get_cycles();
-    start_instret = get_instret();
-    
     test_bf16_add();
-          
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
-
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
-    
-    /* Subtraction */
-    start_cycles = get_cycles();
-    start_instret = get_instret();
-    
     test_bf16_sub();
-          
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
-
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
-    
-    /* Floating point Multiplication */
-    start_cycles = get_cycles();
-    start_instret = get_instret();
-    
     test_bf16_mul();
-          
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
-
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
-
-    /* Floating point Division */
-    start_cycles = get_cycles();
-    start_instret = get_instret();
-    
     test_bf16_div();
-          
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
-
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
-
-    /* Floating point Square Root */
-    start_cycles = get_cycles();
-    start_instret = get_instret();
-    
     test_bf16_sqrt();
-          
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
-
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
 
     /* Floating point Specail cases */
-
-    /* NaN checks */
-    start_cycles = get_cycles();
-    start_instret = get_instret();
-
     test_bf16_NaN();
-
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
-
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
-
-    /* Inf checks */
-    start_cycles = get_cycles();
-    start_instret = get_instret();
-
     test_bf16_INF();
-
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
-
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
-
-    /* Zero checks */
-    start_cycles = get_cycles();
-    start_instret = get_instret();
-
     test_bf16_ZERO();
-
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
-
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");   
-
-    /* Equality checks */
-    start_cycles = get_cycles();
-    start_instret = get_instret();
-
     test_bf16_EQUAL();
-
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
-
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
-    
-
-    /* less than */
-    start_cycles = get_cycles();
-    start_instret = get_instret();
-
     test_bf16_LT();
-
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
-
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
-
-    /* Greater than */
-    start_cycles = get_cycles();
-    start_instret = get_instret();
-
     test_bf16_GT();
 
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
-
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
+    test_spec_kernels();
+}
 
+static void run_hanoi(void)
+{
+    hanoi(4);
 }
 
 static void test_hanoi(void)
 {
-    uint64_t start_cycles, end_cycles, cycles_elapsed;
-    uint64_t start_instret, end_instret, instret_elapsed;
+    /* hanoi prints, so a single run without warm-up per output mode */
+    static const struct bench_case hanoi_cases[2] = {
+        {.name = "hanoi unbuffered", .run = run_hanoi, .ops = 15, .reps = 1},
+        {.name = "hanoi line-buf", .run = run_hanoi, .ops = 15, .reps = 1},
+    };
+    struct bench_stats st[2];
+    unsigned long start_ecalls, ecalls[2];
+
     TEST_LOGGER("--------------------\n");
     TEST_LOGGER("Test: My hanoi\n");
 
-    start_cycles = get_cycles();
-    start_instret = get_instret();
-    hanoi(4);
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
+    /* Same output with one ecall per fragment, then line-buffered */
+    for (int buffered = 0; buffered < 2; buffered++) {
+        out_set_mode(buffered ? OUT_LINE : OUT_UNBUFFERED);
+        start_ecalls = out_ecalls();
+        bench_measure(&hanoi_cases[buffered], &st[buffered]);
+        ecalls[buffered] = out_ecalls() - start_ecalls;
+        out_set_mode(OUT_LINE);
+    }
 
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
+    bench_header("hanoi");
+    for (int buffered = 0; buffered < 2; buffered++)
+        bench_report("hanoi", &hanoi_cases[buffered], &st[buffered]);
+    TEST_LOGGER("  Ecalls: unbuffered ");
+    print_dec_end(ecalls[0], ',');
+    TEST_LOGGER(" line-buffered ");
+    print_dec(ecalls[1]);
 }
 
 static void test_rsqrt(void)
 {
-    uint64_t start_cycles, end_cycles, cycles_elapsed;
-    uint64_t start_instret, end_instret, instret_elapsed;
     uint32_t x = 5;
     uint32_t expect = 0x727c;
     uint32_t rt;
 
-    start_cycles = get_cycles();
-    start_instret = get_instret();
     rt = fast_rsqrt(x);
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
     if (rt == expect) {
         TEST_LOGGER("Reciprocal Square Root\t\tPASSED\n");
     }
+}
+
+/* my_mul against the bit-serial baseline, one operand width at a time */
+#define MUL_BENCH_REPS 16
+
+static void test_mul_bench(void)
+{
+    static const uint8_t widths[] = {1, 4, 8, 12, 16, 20, 24, 28, 32};
+    uint64_t start_cycles, fast_cycles, serial_cycles;
+    volatile uint64_t sink = 0;
+    bool ok = true;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: my_mul vs bit-serial (cycles per call)\n");
+
+    for (unsigned i = 0; i < sizeof(widths); i++) {
+        uint32_t w = widths[i];
+        uint32_t a = (0xA5A5A5A5u >> (32 - w)) | (1u << (w - 1));
+        uint32_t b = (0x5A5A5A5Au >> (32 - w)) | (1u << (w - 1));
+        uint64_t fast = 0, serial = 0;
+
+        start_cycles = get_cycles();
+        for (int r = 0; r < MUL_BENCH_REPS; r++)
+            fast = mul32(a, b);
+        fast_cycles = get_cycles() - start_cycles;
+        sink += fast;
+
+        start_cycles = get_cycles();
+        for (int r = 0; r < MUL_BENCH_REPS; r++)
+            serial = mul32_bitserial(a, b);
+        serial_cycles = get_cycles() - start_cycles;
+        sink += serial;
+
+        if (fast != serial)
+            ok = false;
+
+        TEST_LOGGER("  width=");
+        print_dec_end(w, '\t');
+        TEST_LOGGER("my_mul: ");
+        print_dec_end(udiv((unsigned long) fast_cycles, MUL_BENCH_REPS), '\t');
+        TEST_LOGGER("bit-serial: ");
+        print_dec(udiv((unsigned long) serial_cycles, MUL_BENCH_REPS));
+    }
+
+    if (ok) {
+        TEST_LOGGER("my_mul == bit-serial \tPASSED\n");
+    } else {
+        TEST_LOGGER("my_mul == bit-serial \tFAILED\n");
+    }
+}
+
+/* Power-of-ten subtraction, the 32-bit out_dec path fmt_u64 replaced */
+static size_t dec_pow10(char *buf, unsigned long val)
+{
+    static const unsigned long pow10[] = {
+        1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+        10000UL,      1000UL,      100UL,      10UL,      1UL,
+    };
+    size_t len = 0;
+
+    for (int i = 0; i < 10; i++) {
+        char digit = '0';
+
+        while (val >= pow10[i]) {
+            val -= pow10[i];
+            digit++;
+        }
+        if (digit != '0' || len || i == 9)
+            buf[len++] = digit;
+    }
+    return len;
+}
+
+#define FMT_BENCH_REPS 8
+
+static void test_fmt_bench(void)
+{
+    static const uint64_t values[] = {
+        0, 7, 12345, 987654321, 4294967295ULL,
+        1234567890123ULL, 18446744073709551615ULL,
+    };
+    char ref[FMT_U64_MAX], out[FMT_U64_MAX];
+    uint64_t start_cycles, pow10_cycles, fmt_cycles;
+    size_t ref_len = 0, out_len = 0;
+    bool ok = true;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: decimal formatting (cycles per value)\n");
+
+    for (unsigned i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        uint64_t val = values[i];
+        bool narrow = (val >> 32) == 0;
+
+        start_cycles = get_cycles();
+        for (int r = 0; r < FMT_BENCH_REPS; r++)
+            out_len = fmt_u64(out, val, 0, 0);
+        fmt_cycles = get_cycles() - start_cycles;
+
+        out_u64(val, 26, FMT_COMMA);
+        if (narrow) {
+            start_cycles = get_cycles();
+            for (int r = 0; r < FMT_BENCH_REPS; r++)
+                ref_len = dec_pow10(ref, (unsigned long) val);
+            pow10_cycles = get_cycles() - start_cycles;
+
+            if (ref_len != out_len)
+                ok = false;
+            for (size_t k = 0; k < out_len && k < ref_len; k++) {
+                if (ref[k] != out[k])
+                    ok = false;
+            }
+            TEST_LOGGER("  pow10: ");
+            print_dec_end(udiv((unsigned long) pow10_cycles, FMT_BENCH_REPS), '\t');
+        } else {
+            TEST_LOGGER("  pow10: -\t");
+        }
+        TEST_LOGGER("fmt_u64: ");
+        print_dec(udiv((unsigned long) fmt_cycles, FMT_BENCH_REPS));
+    }
+
+    if (ok) {
+        TEST_LOGGER("fmt_u64 == pow10 \tPASSED\n");
+    } else {
+        TEST_LOGGER("fmt_u64 == pow10 \tFAILED\n");
+    }
+}
+
+static void test_bf16_rsqrt(void)
+{
+    f32_t x;
+    uint32_t x_bf;
+    uint32_t expect = 0x3ee5;
+    uint32_t rt;
 
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
+    x.value = 5.0f;
+    x_bf = f32_to_bf16(x.bits);
+
+    rt = bf16_rsqrt(x_bf);
+    if (rt == expect) {
+        TEST_LOGGER("Reciprocal Square Root (bf16)\tPASSED\n");
+    } else {
+        TEST_LOGGER("Reciprocal Square Root (bf16)\tFAILED (expected 0x3ee5)\n");
+    }
 }
 
 static void test_hero(void) {
-    uint64_t start_cycles, end_cycles, cycles_elapsed;
-    uint64_t start_instret, end_instret, instret_elapsed;
     f32_t a, b, c;
     bf16_t a_bf, b_bf, c_bf;
     a.value = 1.1f;
@@ -833,13 +718,7 @@ static void test_hero(void) {
     uint32_t expect = 0x3f1c;
     uint32_t rt_bf;
 
-    start_cycles = get_cycles();
-    start_instret = get_instret();
     rt_bf = hero(a_bf, b_bf, c_bf);
-    end_cycles = get_cycles();
-    end_instret = get_instret();
-    cycles_elapsed = end_cycles - start_cycles;
-    instret_elapsed = end_instret - start_instret;
     if (rt_bf == expect) {
         TEST_LOGGER("hero's formula\t\tPASSED\n");
     }
@@ -847,19 +726,2202 @@ static void test_hero(void) {
         TEST_LOGGER("hero's formula\t\tFalied\n");
         print_hex(rt_bf);
     }
+}
+
+/* ============= Kernel Benchmarks ============= */
+/* Same operands as the tests above: 3.0 and 5.5, sqrt(5.0), hero(1.1, 1.2,
+ * 1.3). Results go to bench_sink so the calls cannot be dropped. */
+static uint32_t bench_x, bench_y;
+static bf16_t bench_a, bench_b, bench_c;
+static volatile uint32_t bench_sink;
+
+static void setup_bf16_pair(void)
+{
+    f32_t in1, in2;
+    in1.value = 3.0f;
+    in2.value = 5.5f;
+    bench_x = f32_to_bf16(in1.bits);
+    bench_y = f32_to_bf16(in2.bits);
+}
+
+static void setup_bf16_five(void)
+{
+    f32_t in;
+    in.value = 5.0f;
+    bench_x = f32_to_bf16(in.bits);
+}
+
+static void setup_hero(void)
+{
+    f32_t a, b, c;
+    a.value = 1.1f;
+    b.value = 1.2f;
+    c.value = 1.3f;
+    bench_a.bits = f32_to_bf16(a.bits);
+    bench_b.bits = f32_to_bf16(b.bits);
+    bench_c.bits = f32_to_bf16(c.bits);
+}
+
+static void run_bf16_add(void)
+{
+    bench_sink = my_add(bench_x, bench_y, 0, 25, 7, 15);
+}
+
+static void run_bf16_sub(void)
+{
+    bench_sink = my_sub(bench_x, bench_y, 0, 25, 7, 15);
+}
+
+static void run_bf16_mul(void)
+{
+    bench_sink = my_fp_mul(bench_x, bench_y, 0, 25, 7, 15, 15);
+}
+
+static void run_bf16_div(void)
+{
+    bench_sink = my_div(bench_x, bench_y, 0, 25, 7, 15, 15);
+}
+
+static void run_bf16_div_recip(void)
+{
+    bench_sink = my_div_recip(bench_x, bench_y, 0, 25, 7, 15, 15);
+}
+
+static void run_bf16_sqrt(void)
+{
+    bench_sink = my_sqrt(bench_x);
+}
+
+static void run_bf16_rsqrt(void)
+{
+    bench_sink = bf16_rsqrt(bench_x);
+}
+
+static void run_fast_rsqrt(void)
+{
+    bench_sink = fast_rsqrt(5);
+}
+
+static void run_hero(void)
+{
+    bench_sink = hero(bench_a, bench_b, bench_c);
+}
+
+/* Integer helpers that the ISA flavors replace with mul/mulhu/divu/clz */
+static void setup_u32_pair(void)
+{
+    bench_x = 0x9E3779B9;
+    bench_y = 0x00012345;
+}
+
+static void run_my_mul(void)
+{
+    uint32_t hi;
+    bench_sink = my_mul(bench_x, bench_y, 0, 0, 0, 0, 0, &hi) ^ hi;
+}
+
+static void run_my_clz(void)
+{
+    bench_sink = my_clz(bench_y);
+}
+
+static void run_udiv(void)
+{
+    bench_sink = udiv(bench_x, bench_y);
+}
+
+static const struct bench_case kernel_cases[] = {
+    {.name = "bf16 add", .setup = setup_bf16_pair, .run = run_bf16_add},
+    {.name = "bf16 sub", .setup = setup_bf16_pair, .run = run_bf16_sub},
+    {.name = "bf16 mul", .setup = setup_bf16_pair, .run = run_bf16_mul},
+    {.name = "bf16 div", .setup = setup_bf16_pair, .run = run_bf16_div},
+    {.name = "bf16 div (recip)", .setup = setup_bf16_pair,
+     .run = run_bf16_div_recip},
+    {.name = "bf16 sqrt", .setup = setup_bf16_five, .run = run_bf16_sqrt},
+    {.name = "bf16 rsqrt", .setup = setup_bf16_five, .run = run_bf16_rsqrt},
+    {.name = "fast_rsqrt (Q16)", .run = run_fast_rsqrt},
+    {.name = "hero", .setup = setup_hero, .run = run_hero},
+    {.name = "my_mul 32x32", .setup = setup_u32_pair, .run = run_my_mul},
+    {.name = "my_clz", .setup = setup_u32_pair, .run = run_my_clz},
+    {.name = "udiv", .setup = setup_u32_pair, .run = run_udiv},
+};
+
+static void test_kernel_bench(void)
+{
+    bench_run("kernels", kernel_cases,
+              sizeof(kernel_cases) / sizeof(kernel_cases[0]));
+}
+
+/* ============= Special-Case Dispatch ============= */
+/* my_add, my_fp_mul, my_div and my_sqrt per operand class: 3.0 against
+ * each class (sqrt: the class alone). A normal pair takes the fast path,
+ * every other pair the fclass-style dispatch table in bfloat16.S. */
+enum { CLASS_NORMAL, CLASS_ZERO, CLASS_SUBNORMAL, CLASS_INF, CLASS_NAN };
+
+static const uint16_t class_operand[5] = {
+    0x40B0, 0x0000, 0x0040, 0x7F80, 0x7FC0, /* 5.5, 0, 2^-127, inf, NaN */
+};
+
+struct class_case {
+    const char *name;
+    uint8_t op; /* 0 add, 1 mul, 2 div, 3 sqrt */
+    uint8_t cls;
+};
+
+static const struct class_case class_cases[] = {
+    {"add normal", 0, CLASS_NORMAL},   {"add zero", 0, CLASS_ZERO},
+    {"add subnormal", 0, CLASS_SUBNORMAL}, {"add inf", 0, CLASS_INF},
+    {"add NaN", 0, CLASS_NAN},         {"mul normal", 1, CLASS_NORMAL},
+    {"mul zero", 1, CLASS_ZERO},       {"mul subnormal", 1, CLASS_SUBNORMAL},
+    {"mul inf", 1, CLASS_INF},         {"mul NaN", 1, CLASS_NAN},
+    {"div normal", 2, CLASS_NORMAL},   {"div zero", 2, CLASS_ZERO},
+    {"div subnormal", 2, CLASS_SUBNORMAL}, {"div inf", 2, CLASS_INF},
+    {"div NaN", 2, CLASS_NAN},         {"sqrt normal", 3, CLASS_NORMAL},
+    {"sqrt zero", 3, CLASS_ZERO},      {"sqrt subnormal", 3, CLASS_SUBNORMAL},
+    {"sqrt inf", 3, CLASS_INF},        {"sqrt NaN", 3, CLASS_NAN},
+};
+
+static uint32_t class_op;
+
+static void run_class(void)
+{
+    switch (class_op) {
+    case 0:
+        bench_sink = my_add(bench_x, bench_y, 0, 25, 7, 15);
+        break;
+    case 1:
+        bench_sink = my_fp_mul(bench_x, bench_y, 0, 25, 7, 15, 15);
+        break;
+    case 2:
+        bench_sink = my_div(bench_x, bench_y, 0, 25, 7, 15, 15);
+        break;
+    default:
+        bench_sink = my_sqrt(bench_y);
+        break;
+    }
+}
+
+static void test_class_bench(void)
+{
+    struct bench_case c = {.run = run_class};
+    struct bench_stats st;
+
+    bench_header("special-case dispatch");
+    for (uint32_t i = 0; i < sizeof(class_cases) / sizeof(class_cases[0]);
+         i++) {
+        bench_x = 0x4040; /* 3.0 */
+        bench_y = class_operand[class_cases[i].cls];
+        class_op = class_cases[i].op;
+        c.name = class_cases[i].name;
+        bench_measure(&c, &st);
+        bench_report("special-case dispatch", &c, &st);
+    }
+}
+
+/* ============= bf16 Conformance ============= */
+/* Golden results from bf16_golden.c, generated on the host at build time:
+ * every bf16 encoding for the unary ops and a seeded sample of operand
+ * pairs for the binary ones. */
+#define GOLDEN_NAN 0x1
+#define GOLDEN_INF 0x2
+#define GOLDEN_ZERO 0x4
+
+#define GOLDEN_EQ 0x1
+#define GOLDEN_LT 0x2
+#define GOLDEN_GT 0x4
+
+/* bf16_golden_pairs row layout */
+enum {
+    GOLDEN_A,
+    GOLDEN_B,
+    GOLDEN_ADD,
+    GOLDEN_SUB,
+    GOLDEN_MUL,
+    GOLDEN_DIV,
+    GOLDEN_CMP,
+    GOLDEN_PAD,
+    GOLDEN_ROW,
+};
+
+extern const uint16_t bf16_golden_sqrt[65536];
+extern const uint8_t bf16_golden_class[65536];
+extern const uint16_t bf16_golden_cvt[2 * 65536]; /* {low half, result} */
+extern const uint32_t bf16_golden_npairs;
+extern const uint16_t bf16_golden_pairs[][GOLDEN_ROW];
+extern const uint16_t bf16_golden_fma[][4]; /* {a, b, c, a*b + c} */
+/* {exp, log2, sigmoid, tanh, recip} of every encoding, rounded libm */
+extern const uint16_t bf16_golden_math[65536][5];
+
+typedef uint32_t (*conf_binop)(uint32_t, uint32_t);
+
+struct conf_case {
+    struct bench_case bench;
+    conf_binop op; /* pair cases only */
+    int col;
+};
+
+struct conf_result {
+    uint32_t mismatches;
+    uint32_t in1, in2, got, want; /* first mismatch */
+};
+
+static const struct conf_case *conf_cur_case;
+static struct conf_result conf_res;
+
+static void conf_check(uint32_t in1, uint32_t in2, uint32_t got, uint32_t want)
+{
+    if (got == want)
+        return;
+    if (conf_res.mismatches++ == 0) {
+        conf_res.in1 = in1;
+        conf_res.in2 = in2;
+        conf_res.got = got;
+        conf_res.want = want;
+    }
+}
 
-    TEST_LOGGER("  Cycles: ");
-    print_dec((unsigned long) cycles_elapsed);
-    TEST_LOGGER("  Instructions: ");
-    print_dec((unsigned long) instret_elapsed);
-    TEST_LOGGER("\n");
+static void conf_run_sqrt(void)
+{
+    for (uint32_t x = 0; x < 65536; x++)
+        conf_check(x, 0, my_sqrt(x), bf16_golden_sqrt[x]);
 }
+
+static void conf_run_cvt(void)
+{
+    for (uint32_t x = 0; x < 65536; x++) {
+        uint32_t f = (x << 16) | bf16_golden_cvt[2 * x];
+
+        conf_check(f, 0, f32_to_bf16(f), bf16_golden_cvt[2 * x + 1]);
+        conf_check(x, 0, bf16_to_f32(x), x << 16);
+    }
+}
+
+static void conf_run_class(void)
+{
+    for (uint32_t x = 0; x < 65536; x++) {
+        uint32_t c = 0;
+
+        if (is_nan(x, 0, 0, 25, 7))
+            c |= GOLDEN_NAN;
+        if (is_inf(x, 0, 0, 25, 7))
+            c |= GOLDEN_INF;
+        if (is_zero(x, 0, 0, 17))
+            c |= GOLDEN_ZERO;
+        conf_check(x, 0, c, bf16_golden_class[x]);
+    }
+}
+
+static void conf_run_class_spec(void)
+{
+    for (uint32_t x = 0; x < 65536; x++) {
+        uint32_t c = 0;
+
+        if (bf16_is_nan(x))
+            c |= GOLDEN_NAN;
+        if (bf16_is_inf(x))
+            c |= GOLDEN_INF;
+        if (bf16_is_zero(x))
+            c |= GOLDEN_ZERO;
+        conf_check(x, 0, c, bf16_golden_class[x]);
+    }
+}
+
+static void conf_run_pairs(void)
+{
+    conf_binop op = conf_cur_case->op;
+    int col = conf_cur_case->col;
+
+    for (uint32_t i = 0; i < bf16_golden_npairs; i++) {
+        const uint16_t *row = bf16_golden_pairs[i];
+
+        conf_check(row[GOLDEN_A], row[GOLDEN_B],
+                   op(row[GOLDEN_A], row[GOLDEN_B]), row[col]);
+    }
+}
+
+static uint32_t conf_add(uint32_t a, uint32_t b)
+{
+    return my_add(a, b, 0, 25, 7, 15);
+}
+
+static uint32_t conf_sub(uint32_t a, uint32_t b)
+{
+    return my_sub(a, b, 0, 25, 7, 15);
+}
+
+static uint32_t conf_mul(uint32_t a, uint32_t b)
+{
+    return my_fp_mul(a, b, 0, 25, 7, 15, 15);
+}
+
+static uint32_t conf_div(uint32_t a, uint32_t b)
+{
+    return my_div(a, b, 0, 25, 7, 15, 15);
+}
+
+static uint32_t conf_div_recip(uint32_t a, uint32_t b)
+{
+    return my_div_recip(a, b, 0, 25, 7, 15, 15);
+}
+
+static uint32_t conf_cmp(uint32_t a, uint32_t b)
+{
+    uint32_t c = 0;
+
+    if (is_eq(a, b, 0, 25, 7, 15))
+        c |= GOLDEN_EQ;
+    if (is_lt(a, b, 0, 25, 7, 15))
+        c |= GOLDEN_LT;
+    if (is_gt(a, b, 0, 25, 7, 15))
+        c |= GOLDEN_GT;
+    return c;
+}
+
+static uint32_t conf_cmp_spec(uint32_t a, uint32_t b)
+{
+    return (bf16_eq(a, b) ? GOLDEN_EQ : 0) | (bf16_lt(a, b) ? GOLDEN_LT : 0) |
+           (bf16_gt(a, b) ? GOLDEN_GT : 0);
+}
+
+/* ops 0 on the pair cases is filled in with bf16_golden_npairs, so the
+ * eq/lt/gt rows count one op per pair (three kernel calls) */
+static const struct conf_case conf_cases[] = {
+    {{"sqrt (all)", NULL, conf_run_sqrt, 65536, 1}},
+    {{"f32<->bf16 (all)", NULL, conf_run_cvt, 2 * 65536, 1}},
+    {{"is_* (all)", NULL, conf_run_class, 3 * 65536, 1}},
+    {{"bf16_is_* (all)", NULL, conf_run_class_spec, 3 * 65536, 1}},
+    {{"add", NULL, conf_run_pairs, 0, 1}, conf_add, GOLDEN_ADD},
+    {{"sub", NULL, conf_run_pairs, 0, 1}, conf_sub, GOLDEN_SUB},
+    {{"mul", NULL, conf_run_pairs, 0, 1}, conf_mul, GOLDEN_MUL},
+    {{"div", NULL, conf_run_pairs, 0, 1}, conf_div, GOLDEN_DIV},
+    {{"div (recip)", NULL, conf_run_pairs, 0, 1}, conf_div_recip, GOLDEN_DIV},
+    {{"eq/lt/gt", NULL, conf_run_pairs, 0, 1}, conf_cmp, GOLDEN_CMP},
+    {{"bf16_add", NULL, conf_run_pairs, 0, 1}, bf16_add, GOLDEN_ADD},
+    {{"bf16_sub", NULL, conf_run_pairs, 0, 1}, bf16_sub, GOLDEN_SUB},
+    {{"bf16_mul", NULL, conf_run_pairs, 0, 1}, bf16_mul, GOLDEN_MUL},
+    {{"bf16_div", NULL, conf_run_pairs, 0, 1}, bf16_div, GOLDEN_DIV},
+    {{"bf16_eq/lt/gt", NULL, conf_run_pairs, 0, 1}, conf_cmp_spec,
+     GOLDEN_CMP},
+};
+
+#define CONF_CASES (sizeof(conf_cases) / sizeof(conf_cases[0]))
+
+static void test_bf16_conformance(void)
+{
+    struct conf_result res[CONF_CASES];
+    struct bench_case c;
+    struct bench_stats st;
+    unsigned i, failed = 0;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: bf16 conformance vs golden tables\n");
+
+    /* each sweep runs once, so throughput is cycles per checked op */
+    bench_header("conformance");
+    for (i = 0; i < CONF_CASES; i++) {
+        c = conf_cases[i].bench;
+        if (!c.ops)
+            c.ops = bf16_golden_npairs;
+        conf_cur_case = &conf_cases[i];
+        conf_res.mismatches = 0;
+        bench_measure(&c, &st);
+        bench_report("conformance", &c, &st);
+        res[i] = conf_res;
+    }
+
+    for (i = 0; i < CONF_CASES; i++) {
+        TEST_LOGGER("  ");
+        out_puts(conf_cases[i].bench.name);
+        TEST_LOGGER(": ");
+        print_dec_end(res[i].mismatches, ' ');
+        if (res[i].mismatches == 0) {
+            TEST_LOGGER("mismatches\tPASSED\n");
+            continue;
+        }
+        failed++;
+        TEST_LOGGER("mismatches\tFAILED, first (0x");
+        out_hex(res[i].in1);
+        TEST_LOGGER(", 0x");
+        out_hex(res[i].in2);
+        TEST_LOGGER(") got 0x");
+        out_hex(res[i].got);
+        TEST_LOGGER(" want 0x");
+        out_hex(res[i].want);
+        TEST_LOGGER("\n");
+    }
+    if (failed == 0) {
+        TEST_LOGGER("bf16 conformance \t\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("bf16 conformance \t\tFAILED\n");
+    }
+}
+
+/* ============= bf16 Array Throughput ============= */
+#define TP_MAX 4096
+
+enum { TP_ADD, TP_SUB, TP_MUL, TP_DIV, TP_SQRT, TP_OPS };
+
+static const char *const tp_name[TP_OPS] = {
+    "add  ", "sub  ", "mul  ", "div  ", "sqrt ",
+};
+
+static uint16_t tp_a[TP_MAX], tp_b[TP_MAX], tp_ref[TP_MAX], tp_out[TP_MAX];
+
+/* One per-element call per value, the way callers did it before *_n */
+static void tp_scalar(int op, uint32_t n)
+{
+    uint32_t i;
+
+    switch (op) {
+    case TP_ADD:
+        for (i = 0; i < n; i++)
+            tp_ref[i] = my_add(tp_a[i], tp_b[i], 0, 25, 7, 15);
+        break;
+    case TP_SUB:
+        for (i = 0; i < n; i++)
+            tp_ref[i] = my_sub(tp_a[i], tp_b[i], 0, 25, 7, 15);
+        break;
+    case TP_MUL:
+        for (i = 0; i < n; i++)
+            tp_ref[i] = my_fp_mul(tp_a[i], tp_b[i], 0, 25, 7, 15, 15);
+        break;
+    case TP_DIV:
+        for (i = 0; i < n; i++)
+            tp_ref[i] = my_div(tp_a[i], tp_b[i], 0, 25, 7, 15, 15);
+        break;
+    default:
+        for (i = 0; i < n; i++)
+            tp_ref[i] = my_sqrt(tp_a[i]);
+        break;
+    }
+}
+
+static void tp_batched(int op, uint32_t n)
+{
+    switch (op) {
+    case TP_ADD:
+        bf16_add_n(tp_out, tp_a, tp_b, n);
+        break;
+    case TP_SUB:
+        bf16_sub_n(tp_out, tp_a, tp_b, n);
+        break;
+    case TP_MUL:
+        bf16_mul_n(tp_out, tp_a, tp_b, n);
+        break;
+    case TP_DIV:
+        bf16_div_n(tp_out, tp_a, tp_b, n);
+        break;
+    default:
+        bf16_sqrt_n(tp_out, tp_a, n);
+        break;
+    }
+}
+
+static void test_bf16_throughput(void)
+{
+    uint64_t start_cycles, scalar_cycles, batched_cycles;
+    uint32_t i, n;
+    int op;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: bf16 array throughput (cycles/elem)\n");
+
+    /* operands in [1, 2) and +-[2, 4), so every op takes its normal path */
+    for (i = 0; i < TP_MAX; i++) {
+        tp_a[i] = 0x3f80 | ((i * 29) & 0x7f);
+        tp_b[i] = 0x4000 | ((i * 71) & 0x7f) | ((i & 1) << 15);
+    }
+
+    for (op = 0; op < TP_OPS; op++) {
+        for (n = 1; n <= TP_MAX; n <<= 2) {
+            start_cycles = get_cycles();
+            tp_scalar(op, n);
+            scalar_cycles = get_cycles() - start_cycles;
+
+            start_cycles = get_cycles();
+            tp_batched(op, n);
+            batched_cycles = get_cycles() - start_cycles;
+
+            TEST_OUTPUT(tp_name[op], 5);
+            TEST_LOGGER("n=");
+            print_dec_end(n, '\t');
+            TEST_LOGGER("scalar: ");
+            print_dec_end(udiv((unsigned long) scalar_cycles, n), '\t');
+            TEST_LOGGER("batched: ");
+            print_dec(udiv((unsigned long) batched_cycles, n));
+        }
+
+        /* n == TP_MAX ran last, so both buffers hold the full results */
+        for (i = 0; i < TP_MAX; i++) {
+            if (tp_ref[i] != tp_out[i])
+                break;
+        }
+        TEST_OUTPUT(tp_name[op], 5);
+        if (i == TP_MAX) {
+            TEST_LOGGER("batched == scalar \tPASSED\n");
+        }
+        else {
+            TEST_LOGGER("batched == scalar \tFAILED\n");
+        }
+    }
+}
+
+/* ============= bf16 Packed Conversion ============= */
+#define CV_MAX 4096
+
+static uint32_t cv_f32[CV_MAX], cv_back[CV_MAX];
+static bf16x2_t cv_packed[CV_MAX / 2];
+static uint16_t cv_scalar[CV_MAX];
+
+/* f32_to_bf16, with the quiet NaN the streaming kernel returns */
+static uint32_t cv_expect(uint32_t f)
+{
+    if ((f << 1) > 0xFF000000u)
+        return (f >> 16) | 0x40;
+    return f32_to_bf16(f);
+}
+
+/* Every bf16 high half with the golden low halves (ties included), then
+ * the odd tail: it may only touch the low half of the last word. */
+static void test_bf16_convert_n(void)
+{
+    bool pack_ok = true, unpack_ok = true;
+    uint32_t base, i;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: bf16 packed conversion\n");
+
+    for (base = 0; base < 65536; base += CV_MAX) {
+        for (i = 0; i < CV_MAX; i++)
+            cv_f32[i] = ((base + i) << 16) | bf16_golden_cvt[2 * (base + i)];
+        f32_to_bf16_n(cv_packed, cv_f32, CV_MAX);
+        bf16_to_f32_n(cv_back, cv_packed, CV_MAX);
+        for (i = 0; i < CV_MAX; i++) {
+            bf16_t h = bf16x2_get(cv_packed[i >> 1], i & 1);
+
+            if (h.bits != cv_expect(cv_f32[i]))
+                pack_ok = false;
+            if (cv_back[i] != (uint32_t) h.bits << 16)
+                unpack_ok = false;
+        }
+    }
+
+    cv_packed[1].bits = 0xFFFFFFFF;
+    cv_back[3] = 0xFFFFFFFF;
+    f32_to_bf16_n(cv_packed, cv_f32, 3);
+    bf16_to_f32_n(cv_back, cv_packed, 3);
+    if ((cv_packed[1].bits >> 16) != 0xFFFF ||
+        (cv_packed[1].bits & 0xFFFF) != cv_expect(cv_f32[2]))
+        pack_ok = false;
+    if (cv_back[2] != cv_packed[1].bits << 16 || cv_back[3] != 0xFFFFFFFF)
+        unpack_ok = false;
+
+    if (pack_ok) {
+        TEST_LOGGER("f32_to_bf16_n\t\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("f32_to_bf16_n\t\tFAILED\n");
+    }
+    if (unpack_ok) {
+        TEST_LOGGER("bf16_to_f32_n\t\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("bf16_to_f32_n\t\tFAILED\n");
+    }
+}
+
+/* Finite values of both signs over the whole exponent range */
+static void setup_cv(void)
+{
+    uint32_t x = 0x2545F491;
+
+    for (uint32_t i = 0; i < CV_MAX; i++)
+        cv_f32[i] = xorshift32(&x) & 0xFF7FFFFF;
+}
+
+static void run_cv_pack_scalar(void)
+{
+    for (uint32_t i = 0; i < CV_MAX; i++)
+        cv_scalar[i] = f32_to_bf16(cv_f32[i]);
+}
+
+static void run_cv_pack(void)
+{
+    f32_to_bf16_n(cv_packed, cv_f32, CV_MAX);
+}
+
+static void run_cv_unpack_scalar(void)
+{
+    for (uint32_t i = 0; i < CV_MAX; i++)
+        cv_back[i] = bf16_to_f32(cv_scalar[i]);
+}
+
+static void run_cv_unpack(void)
+{
+    bf16_to_f32_n(cv_back, cv_packed, CV_MAX);
+}
+
+/* 4 bytes of f32 and 2 of bf16 per element either way */
+static const struct bench_case cv_cases[] = {
+    {.name = "f32_to_bf16 loop", .setup = setup_cv,
+     .run = run_cv_pack_scalar, .ops = CV_MAX, .bytes = 6 * CV_MAX},
+    {.name = "f32_to_bf16_n", .setup = setup_cv, .run = run_cv_pack,
+     .ops = CV_MAX, .bytes = 6 * CV_MAX},
+    {.name = "bf16_to_f32 loop", .run = run_cv_unpack_scalar, .ops = CV_MAX,
+     .bytes = 6 * CV_MAX},
+    {.name = "bf16_to_f32_n", .run = run_cv_unpack, .ops = CV_MAX,
+     .bytes = 6 * CV_MAX},
+};
+
+static void test_bf16_convert_bench(void)
+{
+    bench_run("packed conversion", cv_cases,
+              sizeof(cv_cases) / sizeof(cv_cases[0]));
+}
+
+/* ============= bf16x2 SWAR Ops ============= */
+#define SW_MAX 4096
+
+static bf16x2_t sw_a[SW_MAX / 2], sw_b[SW_MAX / 2], sw_out[SW_MAX / 2];
+static uint16_t sw_scalar[SW_MAX];
+
+/* IEEE less-than from the scalar kernels: is_lt also answers 1 for equal
+ * negatives and inf < inf, both of which is_eq catches. */
+static bool sw_lt_ref(uint32_t a, uint32_t b)
+{
+    return bf16_lt(a, b) && !bf16_eq(a, b);
+}
+
+/* the lane bf16x2_min (or _max) keeps: a NaN loses, -0 is below +0 */
+static uint32_t sw_minmax_ref(uint32_t a, uint32_t b, bool max)
+{
+    uint32_t lo = a, hi = b;
+
+    if (bf16_is_nan(a))
+        return b;
+    if (bf16_is_nan(b))
+        return a;
+    if (sw_lt_ref(b, a) ||
+        (bf16_is_zero(a) && bf16_is_zero(b) && (b & 0x8000) > (a & 0x8000))) {
+        lo = b;
+        hi = a;
+    }
+    return max ? hi : lo;
+}
+
+static uint32_t sw_lane(bf16x2_t v, unsigned i)
+{
+    return bf16x2_get(v, i).bits;
+}
+
+static uint32_t sw_mask(bool c)
+{
+    return c ? 0xFFFF : 0;
+}
+
+/* Classification over every encoding in both lanes, the rest over the
+ * golden operand pairs, two rows per word. */
+static void test_bf16x2_ops(void)
+{
+    bool class_ok = true, cmp_ok = true, minmax_ok = true, sign_ok = true;
+    uint32_t i, l;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: bf16x2 SWAR ops\n");
+
+    for (i = 0; i < 65536; i++) {
+        bf16x2_t v = {i | (0xFFFF - i) << 16};
+        bf16x2_t nan = bf16x2_is_nan(v), inf = bf16x2_is_inf(v);
+        bf16x2_t zero = bf16x2_is_zero(v);
+
+        for (l = 0; l < 2; l++) {
+            uint32_t c = bf16_golden_class[sw_lane(v, l)];
+
+            if (sw_lane(nan, l) != sw_mask(c & GOLDEN_NAN) ||
+                sw_lane(inf, l) != sw_mask(c & GOLDEN_INF) ||
+                sw_lane(zero, l) != sw_mask(c & GOLDEN_ZERO))
+                class_ok = false;
+        }
+    }
+
+    for (i = 0; i + 1 < bf16_golden_npairs; i += 2) {
+        const uint16_t *r0 = bf16_golden_pairs[i], *r1 = bf16_golden_pairs[i + 1];
+        bf16x2_t a = {r0[GOLDEN_A] | (uint32_t) r1[GOLDEN_A] << 16};
+        bf16x2_t b = {r0[GOLDEN_B] | (uint32_t) r1[GOLDEN_B] << 16};
+        bf16x2_t eq = bf16x2_eq(a, b), lt = bf16x2_lt(a, b);
+        bf16x2_t gt = bf16x2_gt(a, b), mn = bf16x2_min(a, b);
+        bf16x2_t mx = bf16x2_max(a, b), cs = bf16x2_copysign(a, b);
+        bf16x2_t ab = bf16x2_abs(a), ng = bf16x2_neg(a);
+
+        for (l = 0; l < 2; l++) {
+            uint32_t x = sw_lane(a, l), y = sw_lane(b, l);
+
+            if (sw_lane(eq, l) != sw_mask(bf16_eq(x, y)) ||
+                sw_lane(lt, l) != sw_mask(sw_lt_ref(x, y)) ||
+                sw_lane(gt, l) != sw_mask(sw_lt_ref(y, x)))
+                cmp_ok = false;
+            if (sw_lane(mn, l) != sw_minmax_ref(x, y, false) ||
+                sw_lane(mx, l) != sw_minmax_ref(x, y, true))
+                minmax_ok = false;
+            if (sw_lane(ab, l) != (x & 0x7FFF) ||
+                sw_lane(ng, l) != (x ^ 0x8000) ||
+                sw_lane(cs, l) != ((x & 0x7FFF) | (y & 0x8000)))
+                sign_ok = false;
+        }
+    }
+
+    if (class_ok) {
+        TEST_LOGGER("bf16x2 classify\t\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("bf16x2 classify\t\tFAILED\n");
+    }
+    if (cmp_ok) {
+        TEST_LOGGER("bf16x2 eq/lt/gt\t\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("bf16x2 eq/lt/gt\t\tFAILED\n");
+    }
+    if (minmax_ok) {
+        TEST_LOGGER("bf16x2 min/max\t\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("bf16x2 min/max\t\tFAILED\n");
+    }
+    if (sign_ok) {
+        TEST_LOGGER("bf16x2 abs/neg/copysign\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("bf16x2 abs/neg/copysign\tFAILED\n");
+    }
+}
+
+/* Random encodings, every eighth lane a NaN or an infinity */
+static void setup_sw(void)
+{
+    uint32_t x = 0x2545F491;
+
+    for (uint32_t i = 0; i < SW_MAX / 2; i++) {
+        xorshift32(&x);
+        sw_a[i].bits = x;
+        sw_b[i].bits = x * 0x9E3779B1u;
+        if ((i & 3) == 0)
+            sw_a[i].bits |= 0x7F80;
+    }
+}
+
+static void run_sw_lt_scalar(void)
+{
+    for (uint32_t i = 0; i < SW_MAX; i++)
+        sw_scalar[i] = bf16_lt(sw_lane(sw_a[i >> 1], i & 1),
+                               sw_lane(sw_b[i >> 1], i & 1));
+}
+
+static void run_sw_lt(void)
+{
+    for (uint32_t i = 0; i < SW_MAX / 2; i++)
+        sw_out[i] = bf16x2_lt(sw_a[i], sw_b[i]);
+}
+
+static void run_sw_nan_scalar(void)
+{
+    for (uint32_t i = 0; i < SW_MAX; i++)
+        sw_scalar[i] = bf16_is_nan(sw_lane(sw_a[i >> 1], i & 1));
+}
+
+static void run_sw_nan(void)
+{
+    for (uint32_t i = 0; i < SW_MAX / 2; i++)
+        sw_out[i] = bf16x2_is_nan(sw_a[i]);
+}
+
+/* what callers wrote before bf16x2_max: compare, then pick */
+static void run_sw_max_scalar(void)
+{
+    for (uint32_t i = 0; i < SW_MAX; i++) {
+        uint32_t a = sw_lane(sw_a[i >> 1], i & 1);
+        uint32_t b = sw_lane(sw_b[i >> 1], i & 1);
+
+        sw_scalar[i] = (bf16_is_nan(a) || bf16_lt(a, b)) ? b : a;
+    }
+}
+
+static void run_sw_max(void)
+{
+    for (uint32_t i = 0; i < SW_MAX / 2; i++)
+        sw_out[i] = bf16x2_max(sw_a[i], sw_b[i]);
+}
+
+/* ops count lanes: a bf16x2 call retires two */
+static const struct bench_case sw_cases[] = {
+    {.name = "bf16_lt loop", .setup = setup_sw, .run = run_sw_lt_scalar,
+     .ops = SW_MAX},
+    {.name = "bf16x2_lt", .run = run_sw_lt, .ops = SW_MAX},
+    {.name = "bf16_is_nan loop", .run = run_sw_nan_scalar, .ops = SW_MAX},
+    {.name = "bf16x2_is_nan", .run = run_sw_nan, .ops = SW_MAX},
+    {.name = "lt/select loop", .run = run_sw_max_scalar, .ops = SW_MAX},
+    {.name = "bf16x2_max", .run = run_sw_max, .ops = SW_MAX},
+};
+
+static void test_bf16x2_bench(void)
+{
+    bench_run("bf16x2 SWAR", sw_cases, sizeof(sw_cases) / sizeof(sw_cases[0]));
+}
+
+/* ============= bf16 Fused Multiply-Add ============= */
+#define FMA_BENCH 256
+
+/* fms is checked as fma with the addend negated; the mul+add count shows
+ * what the single rounding buys over the truncating pair */
+static void test_bf16_fma(void)
+{
+    uint32_t fma_bad = 0, fms_bad = 0, pair_off = 0;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: bf16 fused multiply-add\n");
+
+    for (uint32_t i = 0; i < bf16_golden_npairs; i++) {
+        const uint16_t *row = bf16_golden_fma[i];
+
+        if (bf16_fma(row[0], row[1], row[2]) != row[3])
+            fma_bad++;
+        if (bf16_fms(row[0], row[1], row[2] ^ 0x8000) != row[3])
+            fms_bad++;
+        if (bf16_add(bf16_mul(row[0], row[1]), row[2]) != row[3])
+            pair_off++;
+    }
+
+    TEST_LOGGER("  bf16_mul+bf16_add off in ");
+    print_dec_end(pair_off, ' ');
+    TEST_LOGGER("of ");
+    print_dec_end(bf16_golden_npairs, '\n');
+    if (fma_bad == 0) {
+        TEST_LOGGER("bf16_fma\t\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("bf16_fma\t\tFAILED\n");
+    }
+    if (fms_bad == 0) {
+        TEST_LOGGER("bf16_fms\t\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("bf16_fms\t\tFAILED\n");
+    }
+}
+
+static void run_fma_pair(void)
+{
+    for (uint32_t i = 0; i < FMA_BENCH; i++) {
+        const uint16_t *row = bf16_golden_fma[i];
+
+        bench_sink = bf16_add(bf16_mul(row[0], row[1]), row[2]);
+    }
+}
+
+static void run_fma(void)
+{
+    for (uint32_t i = 0; i < FMA_BENCH; i++) {
+        const uint16_t *row = bf16_golden_fma[i];
+
+        bench_sink = bf16_fma(row[0], row[1], row[2]);
+    }
+}
+
+/* the first golden triples: specials, cancellation and sticky cases */
+static const struct bench_case fma_cases[] = {
+    {.name = "bf16_mul+bf16_add", .run = run_fma_pair, .ops = FMA_BENCH},
+    {.name = "bf16_fma", .run = run_fma, .ops = FMA_BENCH},
+};
+
+static void test_bf16_fma_bench(void)
+{
+    bench_run("fused multiply-add", fma_cases,
+              sizeof(fma_cases) / sizeof(fma_cases[0]));
+}
+
+/* ============= bf16 Linear Algebra ============= */
+#define LA_MAX 32
+
+static uint16_t la_a[LA_MAX * LA_MAX], la_b[LA_MAX * LA_MAX];
+static uint32_t la_c[LA_MAX * LA_MAX];
+static uint32_t la_m, la_n, la_k;
+
+/* bf16 of either sign with exponents 120..127, so sums stay finite */
+static void la_fill(uint16_t *v, uint32_t n, uint32_t x)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        xorshift32(&x);
+        v[i] = (x & 0x807F) | (0x3C00 + ((x >> 1) & 0x0380));
+    }
+}
+
+/* a*b widened exactly: {a, b, f32 product} */
+static const uint32_t la_mul_cases[][3] = {
+    {0x3FC0, 0x3FC0, 0x40100000}, /* 1.5 * 1.5 */
+    {0x3F81, 0x3F81, 0x3F820200}, /* all 16 product bits kept */
+    {0xC000, 0x4040, 0xC0C00000}, /* -2 * 3 */
+    {0x0001, 0x3F80, 0x00010000}, /* subnormal stays exact */
+    {0x0080, 0x0080, 0x00000000}, /* underflow */
+    {0x7F7F, 0x7F7F, 0x7F800000}, /* overflow */
+    {0xFF80, 0x4000, 0xFF800000}, /* -inf * 2 */
+    {0x7F80, 0x8000, 0x7FC00000}, /* inf * 0 */
+    {0x7FC1, 0x3F80, 0x7FC10000}, /* NaN passes through */
+};
+
+/* dot, gemv and gemm must match the scalar loop bit for bit: same
+ * products, same order of f32 additions */
+static void test_bf16_linalg(void)
+{
+    static const uint32_t sizes[][3] = {
+        {1, 1, 1}, {3, 5, 7}, {17, 16, 18}, {2, 31, 17}, {32, 32, 32},
+    };
+    uint32_t mul_bad = 0, dot_bad = 0, gemv_bad = 0, gemm_bad = 0;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: bf16 dot/gemv/gemm, f32 accumulation\n");
+
+    for (uint32_t i = 0; i < sizeof(la_mul_cases) / sizeof(la_mul_cases[0]);
+         i++) {
+        const uint32_t *row = la_mul_cases[i];
+
+        if (bf16_mul_f32(row[0], row[1]) != row[2])
+            mul_bad++;
+    }
+
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint32_t m = sizes[s][0], n = sizes[s][1], k = sizes[s][2];
+        uint32_t acc, ai, ci;
+
+        la_fill(la_a, LA_MAX * LA_MAX, 0x2545F491 + s);
+        la_fill(la_b, LA_MAX * LA_MAX, 0x9E3779B9 - s);
+
+        acc = 0;
+        for (uint32_t p = 0; p < k; p++)
+            acc = f32_add(acc, bf16_mul_f32(la_a[p], la_b[p]));
+        if (bf16_dot(la_a, la_b, k) != acc)
+            dot_bad++;
+
+        bf16_gemv(la_c, la_a, la_b, m, k);
+        ai = 0;
+        for (uint32_t i = 0; i < m; i++) {
+            acc = 0;
+            for (uint32_t p = 0; p < k; p++)
+                acc = f32_add(acc, bf16_mul_f32(la_a[ai + p], la_b[p]));
+            if (la_c[i] != acc)
+                gemv_bad++;
+            ai += k;
+        }
+
+        bf16_gemm(la_c, la_a, la_b, m, n, k);
+        ai = 0;
+        ci = 0;
+        for (uint32_t i = 0; i < m; i++) {
+            for (uint32_t j = 0; j < n; j++) {
+                uint32_t bi = j;
+
+                acc = 0;
+                for (uint32_t p = 0; p < k; p++) {
+                    acc = f32_add(acc, bf16_mul_f32(la_a[ai + p], la_b[bi]));
+                    bi += n;
+                }
+                if (la_c[ci + j] != acc)
+                    gemm_bad++;
+            }
+            ai += k;
+            ci += n;
+        }
+    }
+
+    if (mul_bad == 0) {
+        TEST_LOGGER("bf16_mul_f32\t\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("bf16_mul_f32\t\tFAILED\n");
+    }
+    if (dot_bad == 0) {
+        TEST_LOGGER("bf16_dot\t\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("bf16_dot\t\tFAILED\n");
+    }
+    if (gemv_bad == 0) {
+        TEST_LOGGER("bf16_gemv\t\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("bf16_gemv\t\tFAILED\n");
+    }
+    if (gemm_bad == 0) {
+        TEST_LOGGER("bf16_gemm\t\tPASSED\n");
+    }
+    else {
+        TEST_LOGGER("bf16_gemm\t\tFAILED\n");
+    }
+}
+
+static void setup_la(void)
+{
+    la_fill(la_a, LA_MAX * LA_MAX, 0x2545F491);
+    la_fill(la_b, LA_MAX * LA_MAX, 0x9E3779B9);
+}
+
+static void run_la_dot(void)
+{
+    bench_sink = bf16_dot(la_a, la_b, la_k);
+}
+
+static void run_la_gemv(void)
+{
+    bf16_gemv(la_c, la_a, la_b, la_m, la_k);
+}
+
+static void run_la_gemm(void)
+{
+    bf16_gemm(la_c, la_a, la_b, la_m, la_n, la_k);
+}
+
+/* square sizes: n for dot, n x n for gemv, n x n x n for gemm; the 32
+ * gemm spans two tiles each way */
+static void test_bf16_linalg_bench(void)
+{
+    static const uint32_t sizes[] = {4, 8, 16, 32};
+    static const char *const names[][3] = {
+        {"bf16_dot 4", "bf16_gemv 4x4", "bf16_gemm 4^3"},
+        {"bf16_dot 8", "bf16_gemv 8x8", "bf16_gemm 8^3"},
+        {"bf16_dot 16", "bf16_gemv 16x16", "bf16_gemm 16^3"},
+        {"bf16_dot 32", "bf16_gemv 32x32", "bf16_gemm 32^3"},
+    };
+    struct bench_case c = {.setup = setup_la, .reps = 3};
+    struct bench_stats st;
+
+    bench_header("bf16 linear algebra");
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint32_t n = sizes[s];
+
+        la_m = n;
+        la_n = n;
+        la_k = n;
+
+        c.name = names[s][0];
+        c.run = run_la_dot;
+        c.ops = n;
+        c.macs = n;
+        bench_measure(&c, &st);
+        bench_report("bf16 linear algebra", &c, &st);
+
+        c.name = names[s][1];
+        c.run = run_la_gemv;
+        c.ops = n << s << 2; /* n * n, n = 4 << s */
+        c.macs = c.ops;
+        bench_measure(&c, &st);
+        bench_report("bf16 linear algebra", &c, &st);
+
+        c.name = names[s][2];
+        c.run = run_la_gemm;
+        c.ops = c.ops << s << 2;
+        c.macs = c.ops;
+        bench_measure(&c, &st);
+        bench_report("bf16 linear algebra", &c, &st);
+    }
+}
+
+/* ============= bf16 Transcendentals ============= */
+#define MATH_FNS 5
+#define MATH_BENCH 256
+
+static uint32_t (*const math_fn[MATH_FNS])(const uint32_t) = {
+    bf16_exp, bf16_log2, bf16_sigmoid, bf16_tanh, bf16_recip,
+};
+static void (*const math_fn_n[MATH_FNS])(uint16_t *,
+                                          const uint16_t *,
+                                          uint32_t) = {
+    bf16_exp_n, bf16_log2_n, bf16_sigmoid_n, bf16_tanh_n, bf16_recip_n,
+};
+static const char *const math_name[MATH_FNS] = {
+    "bf16_exp", "bf16_log2", "bf16_sigmoid", "bf16_tanh", "bf16_recip",
+};
+static const char *const math_name_n[MATH_FNS] = {
+    "bf16_exp_n", "bf16_log2_n", "bf16_sigmoid_n", "bf16_tanh_n", "bf16_recip_n",
+};
+/* ulps each may be off the rounded exact result (bfloat16.h) */
+static const uint8_t math_max_ulp[MATH_FNS] = {1, 0, 1, 1, 0};
+
+static uint16_t math_in[MATH_BENCH], math_out[MATH_BENCH];
+static uint32_t math_cur;
+
+/* distance in ulps, -0 == +0; a NaN only matches the same NaN */
+static uint32_t math_ulp(uint32_t a, uint32_t b)
+{
+    uint32_t ka = (a & 0x8000) ? 0x8000 - (a & 0x7FFF) : 0x8000 + a;
+    uint32_t kb = (b & 0x8000) ? 0x8000 - (b & 0x7FFF) : 0x8000 + b;
+
+    if ((a & 0x7FFF) > 0x7F80 || (b & 0x7FFF) > 0x7F80)
+        return a == b ? 0 : 0xFFFF;
+    return ka > kb ? ka - kb : kb - ka;
+}
+
+/* every encoding against the golden table, then the array variants
+ * against the scalar kernels */
+static void test_bf16_math(void)
+{
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: bf16 exp/log2/sigmoid/tanh/recip, all encodings\n");
+
+    for (uint32_t f = 0; f < MATH_FNS; f++) {
+        uint32_t max_ulp = 0, off = 0, n_bad = 0;
+
+        for (uint32_t x = 0; x < 65536; x++) {
+            uint32_t d = math_ulp(math_fn[f](x), bf16_golden_math[x][f]);
+
+            if (d)
+                off++;
+            if (d > max_ulp)
+                max_ulp = d;
+        }
+        for (uint32_t base = 0; base < 65536; base += MATH_BENCH) {
+            for (uint32_t i = 0; i < MATH_BENCH; i++)
+                math_in[i] = base + i;
+            math_fn_n[f](math_out, math_in, MATH_BENCH);
+            for (uint32_t i = 0; i < MATH_BENCH; i++)
+                if (math_out[i] != math_fn[f](base + i))
+                    n_bad++;
+        }
+
+        TEST_LOGGER("  ");
+        out_puts(math_name[f]);
+        TEST_LOGGER(": max ");
+        print_dec_end(max_ulp, ' ');
+        TEST_LOGGER("ulp, ");
+        print_dec_end(off, ' ');
+        TEST_LOGGER("not correctly rounded\t");
+        if (max_ulp <= math_max_ulp[f] && n_bad == 0) {
+            TEST_LOGGER("PASSED\n");
+        }
+        else {
+            TEST_LOGGER("FAILED\n");
+        }
+    }
+}
+
+/* activations in [-8, 8) of either sign, plus a spread for log2/recip */
+static void setup_math(void)
+{
+    uint32_t x = 0x2545F491;
+
+    for (uint32_t i = 0; i < MATH_BENCH; i++) {
+        xorshift32(&x);
+        math_in[i] = (x & 0x807F) | (0x3B00 + ((x >> 1) & 0x0780));
+    }
+}
+
+static void run_math_scalar(void)
+{
+    uint32_t (*fn)(const uint32_t) = math_fn[math_cur];
+
+    for (uint32_t i = 0; i < MATH_BENCH; i++)
+        math_out[i] = fn(math_in[i]);
+}
+
+static void run_math_n(void)
+{
+    math_fn_n[math_cur](math_out, math_in, MATH_BENCH);
+}
+
+/* what 1/x cost before bf16_recip */
+static void run_math_div(void)
+{
+    for (uint32_t i = 0; i < MATH_BENCH; i++)
+        math_out[i] = bf16_div(0x3F80, math_in[i]);
+}
+
+static void test_bf16_math_bench(void)
+{
+    struct bench_case c = {.setup = setup_math, .ops = MATH_BENCH};
+    struct bench_stats st;
+
+    bench_header("bf16 transcendentals");
+    for (math_cur = 0; math_cur < MATH_FNS; math_cur++) {
+        c.name = math_name[math_cur];
+        c.run = run_math_scalar;
+        bench_measure(&c, &st);
+        bench_report("bf16 transcendentals", &c, &st);
+        c.name = math_name_n[math_cur];
+        c.run = run_math_n;
+        bench_measure(&c, &st);
+        bench_report("bf16 transcendentals", &c, &st);
+    }
+    c.name = "bf16_div 1/x";
+    c.run = run_math_div;
+    bench_measure(&c, &st);
+    bench_report("bf16 transcendentals", &c, &st);
+}
+
+/* ============= Q16 Fixed Point ============= */
+
+enum {
+    Q16_X,
+    Q16_SQRT,
+    Q16_RSQRT,
+    Q16_XS,
+    Q16_RECIP,
+    Q16_A,
+    Q16_SIN,
+    Q16_COS,
+    Q16_Y,
+    Q16_X2,
+    Q16_ATAN2,
+    Q16_ROW,
+};
+
+/* bf16_golden.S: {x, sqrt, rsqrt, xs, recip, a, sin, cos, y, x2, atan2} */
+extern const uint32_t q16_golden_rows;
+extern const uint32_t q16_golden[][Q16_ROW];
+
+#define Q16_FNS 6
+#define Q16_BENCH 64
+
+static const char *const q16_name[Q16_FNS] = {
+    "q16_sqrt", "q16_rsqrt", "q16_recip", "q16_sin", "q16_cos", "q16_atan2",
+};
+/* input (atan2: y, then x2) and result column of each function */
+static const uint8_t q16_in_col[Q16_FNS] = {
+    Q16_X, Q16_X, Q16_XS, Q16_A, Q16_A, Q16_Y,
+};
+static const uint8_t q16_col[Q16_FNS] = {
+    Q16_SQRT, Q16_RSQRT, Q16_RECIP, Q16_SIN, Q16_COS, Q16_ATAN2,
+};
+/* Q16 steps each may be off the rounded exact result, at the defaults */
+static const uint8_t q16_max_err[Q16_FNS] = {0, 1, 0, 1, 1, 1};
+
+static uint32_t q16_in[Q16_BENCH], q16_in2[Q16_BENCH], q16_out[Q16_BENCH];
+static uint32_t q16_cur;
+
+static uint32_t q16_eval(uint32_t f, const uint32_t *row)
+{
+    switch (f) {
+    case 0:
+        return q16_sqrt(row[Q16_X]);
+    case 1:
+        return q16_rsqrt(row[Q16_X]);
+    case 2:
+        return q16_recip(row[Q16_XS]);
+    case 3:
+        return q16_sin(row[Q16_A]);
+    case 4:
+        return q16_cos(row[Q16_A]);
+    default:
+        return q16_atan2(row[Q16_Y], row[Q16_X2]);
+    }
+}
+
+static void q16_eval_n(uint32_t f, uint32_t n)
+{
+    int32_t *out = (int32_t *) q16_out;
+    const int32_t *in = (const int32_t *) q16_in;
+
+    switch (f) {
+    case 0:
+        q16_sqrt_n(q16_out, q16_in, n);
+        break;
+    case 1:
+        q16_rsqrt_n(q16_out, q16_in, n);
+        break;
+    case 2:
+        q16_recip_n(out, in, n);
+        break;
+    case 3:
+        q16_sin_n(out, in, n);
+        break;
+    case 4:
+        q16_cos_n(out, in, n);
+        break;
+    default:
+        q16_atan2_n(out, in, (const int32_t *) q16_in2, n);
+        break;
+    }
+}
+
+/* |got - want| in Q16 steps, rsqrt compared unsigned */
+static uint32_t q16_err(uint32_t f, uint32_t got, uint32_t want)
+{
+    if (f <= 1)
+        return got > want ? got - want : want - got;
+    return (int32_t) got > (int32_t) want ? got - want : want - got;
+}
+
+/* largest error of q16_name[f] over the golden rows */
+static uint32_t q16_max_error(uint32_t f)
+{
+    uint32_t max_err = 0;
+
+    for (uint32_t r = 0; r < q16_golden_rows; r++) {
+        uint32_t d = q16_err(f, q16_eval(f, q16_golden[r]),
+                             q16_golden[r][q16_col[f]]);
+
+        if (d > max_err)
+            max_err = d;
+    }
+    return max_err;
+}
+
+/* the golden inputs of q16_name[f], from row 'base' on, into q16_in/in2 */
+static uint32_t q16_load(uint32_t f, uint32_t base)
+{
+    uint32_t n = q16_golden_rows - base;
+
+    if (n > Q16_BENCH)
+        n = Q16_BENCH;
+    for (uint32_t i = 0; i < n; i++) {
+        const uint32_t *row = q16_golden[base + i];
+
+        q16_in[i] = row[q16_in_col[f]];
+        q16_in2[i] = row[Q16_X2];
+    }
+    return n;
+}
+
+/* the golden rows against each function, then the array variants against
+ * the scalar ones */
+static void test_q16(void)
+{
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: Q16 sqrt/rsqrt/recip/sin/cos/atan2 vs golden\n");
+
+    for (uint32_t f = 0; f < Q16_FNS; f++) {
+        uint32_t max_err = q16_max_error(f), n_bad = 0;
+
+        for (uint32_t base = 0; base < q16_golden_rows; base += Q16_BENCH) {
+            uint32_t n = q16_load(f, base);
+
+            q16_eval_n(f, n);
+            for (uint32_t i = 0; i < n; i++)
+                if (q16_out[i] != q16_eval(f, q16_golden[base + i]))
+                    n_bad++;
+        }
+
+        TEST_LOGGER("  ");
+        out_puts(q16_name[f]);
+        TEST_LOGGER(": max err ");
+        print_dec_end(max_err, ' ');
+        TEST_LOGGER("LSB\t");
+        if (max_err <= q16_max_err[f] && n_bad == 0) {
+            TEST_LOGGER("PASSED\n");
+        }
+        else {
+            TEST_LOGGER("FAILED\n");
+        }
+    }
+}
+
+static void setup_q16(void)
+{
+    q16_load(q16_cur, 0);
+}
+
+static void run_q16_n(void)
+{
+    q16_eval_n(q16_cur, Q16_BENCH);
+}
+
+struct q16_setting {
+    const char *name;
+    uint8_t a, b; /* seg_log2 and Newton steps, or CORDIC steps */
+};
+
+static const struct q16_setting q16_rsqrt_sweep[] = {
+    {"rsqrt 1 seg, 0 newton", 0, 0},   {"rsqrt 1 seg, 1 newton", 0, 1},
+    {"rsqrt 1 seg, 2 newton", 0, 2},   {"rsqrt 4 seg, 0 newton", 2, 0},
+    {"rsqrt 4 seg, 1 newton", 2, 1},   {"rsqrt 4 seg, 2 newton", 2, 2},
+    {"rsqrt 16 seg, 0 newton", 4, 0},  {"rsqrt 16 seg, 1 newton", 4, 1},
+    {"rsqrt 16 seg, 2 newton", 4, 2},  {"rsqrt 64 seg, 0 newton", 6, 0},
+    {"rsqrt 64 seg, 1 newton", 6, 1},  {"rsqrt 64 seg, 2 newton", 6, 2},
+};
+
+static const struct q16_setting q16_cordic_sweep[] = {
+    {"sincos 8 steps", 8, 0},   {"sincos 12 steps", 12, 0},
+    {"sincos 16 steps", 16, 0}, {"sincos 20 steps", 20, 0},
+    {"sincos 24 steps", 24, 0},
+};
+
+static void q16_sweep_point(const char *name, uint32_t f)
+{
+    struct bench_case c = {
+        .name = name, .setup = setup_q16, .run = run_q16_n, .ops = Q16_BENCH};
+    struct bench_stats st;
+
+    q16_cur = f;
+    bench_measure(&c, &st);
+    bench_report("q16 sweep", &c, &st);
+    TEST_LOGGER("  max err ");
+    print_dec_end(q16_max_error(f), ' ');
+    TEST_LOGGER("LSB\n");
+}
+
+/* every function at the defaults, then error against cycles for the
+ * rsqrt table/Newton split and the CORDIC step count */
+static void test_q16_bench(void)
+{
+    struct bench_case c = {
+        .setup = setup_q16, .run = run_q16_n, .ops = Q16_BENCH};
+    struct bench_stats st;
+
+    bench_header("q16");
+    for (q16_cur = 0; q16_cur < Q16_FNS; q16_cur++) {
+        c.name = q16_name[q16_cur];
+        bench_measure(&c, &st);
+        bench_report("q16", &c, &st);
+    }
+
+    bench_header("q16 sweep");
+    for (uint32_t i = 0; i < sizeof(q16_rsqrt_sweep) / sizeof(q16_rsqrt_sweep[0]); i++) {
+        q16_set_rsqrt(q16_rsqrt_sweep[i].a, q16_rsqrt_sweep[i].b);
+        q16_sweep_point(q16_rsqrt_sweep[i].name, 1);
+    }
+    q16_set_rsqrt(Q16_RSQRT_SEG_DEFAULT, Q16_RSQRT_ITERS_DEFAULT);
+    for (uint32_t i = 0; i < sizeof(q16_cordic_sweep) / sizeof(q16_cordic_sweep[0]); i++) {
+        q16_set_cordic(q16_cordic_sweep[i].a);
+        q16_sweep_point(q16_cordic_sweep[i].name, 3);
+    }
+    q16_set_cordic(Q16_CORDIC_DEFAULT);
+}
+
+/* ============= Batched Heron's Formula ============= */
+#define HERO_N 256
+
+static uint16_t hero_a[HERO_N], hero_b[HERO_N], hero_c[HERO_N];
+static uint16_t hero_out[HERO_N];
+
+/* edges first: zero sides, inf/NaN, s flushing to zero in the halving
+ * (exponent 1 and subnormal sums), degenerate and impossible triangles */
+static const uint16_t hero_edge[][3] = {
+    {0x0000, 0x0000, 0x0000}, {0x0080, 0x0000, 0x0000},
+    {0x8080, 0x0000, 0x0000}, {0x0001, 0x0002, 0x0000},
+    {0x7F80, 0x3F80, 0x3F80}, {0x7FC0, 0x3F80, 0x3F80},
+    {0xFF80, 0x3F80, 0x3F80}, {0x7F7F, 0x7F7F, 0x7F7F},
+    {0x3F80, 0x3F80, 0x4000}, {0x3F80, 0x3F80, 0x4080},
+    {0x3F8C, 0x3F99, 0x3FA6}, {0x0100, 0x0100, 0x0100},
+};
+
+/* mostly valid triangles in [1/32, 32), then every fourth triangle with
+ * raw encodings */
+static void setup_hero_n(void)
+{
+    const uint32_t n_edge = sizeof(hero_edge) / sizeof(hero_edge[0]);
+    uint32_t x = 0x2545F491;
+
+    for (uint32_t i = 0; i < HERO_N; i++) {
+        uint16_t v[3];
+
+        for (int k = 0; k < 3; k++) {
+            xorshift32(&x);
+            v[k] = (i & 3) ? 0x3D00 + ((x >> 8) & 0x4FF) : x >> 16;
+        }
+        if (i < n_edge) {
+            v[0] = hero_edge[i][0];
+            v[1] = hero_edge[i][1];
+            v[2] = hero_edge[i][2];
+        }
+        hero_a[i] = v[0];
+        hero_b[i] = v[1];
+        hero_c[i] = v[2];
+    }
+}
+
+static void run_hero_scalar(void)
+{
+    for (uint32_t i = 0; i < HERO_N; i++) {
+        bf16_t a = {hero_a[i]}, b = {hero_b[i]}, c = {hero_c[i]};
+
+        hero_out[i] = hero(a, b, c);
+    }
+}
+
+static void run_hero_n(void)
+{
+    hero_n(hero_out, hero_a, hero_b, hero_c, HERO_N);
+}
+
+static void test_hero_n(void)
+{
+    uint32_t n_bad = 0;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: hero_n == hero\n");
+
+    setup_hero_n();
+    run_hero_n();
+    for (uint32_t i = 0; i < HERO_N; i++) {
+        bf16_t a = {hero_a[i]}, b = {hero_b[i]}, c = {hero_c[i]};
+
+        if (hero_out[i] != hero(a, b, c))
+            n_bad++;
+    }
+    report_mismatches(n_bad);
+}
+
+/* cycles per triangle: the scalar call in a loop against hero_n */
+static const struct bench_case hero_cases[] = {
+    {.name = "hero loop", .setup = setup_hero_n, .run = run_hero_scalar,
+     .ops = HERO_N},
+    {.name = "hero_n", .setup = setup_hero_n, .run = run_hero_n,
+     .ops = HERO_N},
+};
+
+static void test_hero_bench(void)
+{
+    bench_run("hero", hero_cases, sizeof(hero_cases) / sizeof(hero_cases[0]));
+}
+
+/* ============= Hanoi Engine ============= */
+/* sum = rotl(sum, 5) ^ move, the fold hanoi_checksum uses */
+static uint32_t hanoi_fold(uint32_t sum, uint32_t move)
+{
+    return ((sum << 5) | (sum >> 27)) ^ move;
+}
+
+/* Replay hanoi_move(n, 1..2^n - 1) on three stacks: every move must take
+ * the top disk onto an empty peg or a larger disk and the tower must end
+ * on C; the moves must fold to hanoi_checksum(n). */
+static void test_hanoi_engine(void)
+{
+    uint8_t stack[3][HANOI_MAX_DISKS];
+    uint32_t n_bad = 0;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: hanoi_move / hanoi_checksum\n");
+
+    for (uint32_t n = 1; n <= 16; n++) {
+        uint32_t top[3] = {n, 0, 0}, sum = 0;
+
+        for (uint32_t d = 0; d < n; d++)
+            stack[0][d] = n - d;
+        for (uint32_t k = 1; k < (1u << n); k++) {
+            uint32_t m = hanoi_move(n, k);
+            uint32_t disk = m >> 16, from = (m >> 8) & 0xFF, to = m & 0xFF;
+
+            sum = hanoi_fold(sum, m);
+            if (from > 2 || to > 2 || from == to || top[from] == 0 ||
+                stack[from][top[from] - 1] != disk ||
+                (top[to] && stack[to][top[to] - 1] < disk)) {
+                n_bad++;
+                break;
+            }
+            stack[to][top[to]++] = stack[from][--top[from]];
+        }
+        if (top[2] != n || sum != hanoi_checksum(n))
+            n_bad++;
+    }
+    /* out of range k and n give 0; the first move of 4 disks is 1 A->B */
+    if (hanoi_move(4, 0) || hanoi_move(4, 16) ||
+        hanoi_move(HANOI_MAX_DISKS + 1, 1) || hanoi_checksum(0) ||
+        hanoi_move(4, 1) != 0x00010001)
+        n_bad++;
+    report_mismatches(n_bad);
+}
+
+/* cycles per move of the quiet engine as the tower grows; the big towers
+ * run once */
+static uint32_t hanoi_bench_disks;
+
+static void run_hanoi_checksum(void)
+{
+    bench_sink = hanoi_checksum(hanoi_bench_disks);
+}
+
+static const struct bench_case hanoi_scale_cases[] = {
+    {.name = "hanoi_checksum 1", .run = run_hanoi_checksum, .ops = 1},
+    {.name = "hanoi_checksum 2", .run = run_hanoi_checksum, .ops = 3},
+    {.name = "hanoi_checksum 4", .run = run_hanoi_checksum, .ops = 15},
+    {.name = "hanoi_checksum 8", .run = run_hanoi_checksum, .ops = 255},
+    {.name = "hanoi_checksum 12", .run = run_hanoi_checksum, .ops = 4095},
+    {.name = "hanoi_checksum 16", .run = run_hanoi_checksum, .ops = 65535,
+     .reps = 1},
+    {.name = "hanoi_checksum 20", .run = run_hanoi_checksum,
+     .ops = 1048575, .reps = 1},
+    {.name = "hanoi_checksum 24", .run = run_hanoi_checksum,
+     .ops = 16777215, .reps = 1},
+};
+static const uint8_t hanoi_scale_disks[] = {1, 2, 4, 8, 12, 16, 20, 24};
+
+static void test_hanoi_bench(void)
+{
+    const unsigned n =
+        sizeof(hanoi_scale_cases) / sizeof(hanoi_scale_cases[0]);
+
+    bench_header("hanoi scale");
+    for (unsigned i = 0; i < n; i++) {
+        struct bench_stats st;
+
+        hanoi_bench_disks = hanoi_scale_disks[i];
+        bench_measure(&hanoi_scale_cases[i], &st);
+        bench_report("hanoi scale", &hanoi_scale_cases[i], &st);
+    }
+}
+
+/* ============= Arena Allocator ============= */
+static struct arena heap;
+
+static void test_arena(void)
+{
+    static uint32_t region[16];
+    struct arena a;
+    uint32_t n_bad = 0;
+    size_t outer, inner;
+    uint8_t *p, *q;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: arena alloc/mark/reset\n");
+
+    /* region + 1 is odd, so alignment comes from padding: 3 bytes here */
+    arena_init(&a, (uint8_t *) region + 1, sizeof(region) - 1);
+    p = arena_alloc(&a, 3);
+    if (!p || ((uintptr_t) p & (ARENA_ALIGN - 1)) || arena_used(&a) != 6)
+        n_bad++;
+    outer = arena_mark(&a);
+    q = arena_alloc_aligned(&a, 8, 16);
+    if (!q || ((uintptr_t) q & 15) || q < p + 3)
+        n_bad++;
+    inner = arena_mark(&a);
+    /* too big: NULL and nothing moves */
+    if (arena_alloc(&a, sizeof(region)) || arena_mark(&a) != inner)
+        n_bad++;
+    arena_reset(&a, outer);
+    if (arena_used(&a) != outer || arena_peak(&a) != inner)
+        n_bad++;
+    /* the freed space is handed out again */
+    if (arena_alloc_aligned(&a, 8, 16) != q)
+        n_bad++;
+    arena_reset(&a, 0);
+    arena_reset_peak(&a);
+    if (arena_used(&a) || arena_peak(&a) ||
+        !arena_alloc(&a, sizeof(region) - 4) || arena_alloc(&a, 1))
+        n_bad++;
+
+    /* the linker heap */
+    arena_init_heap(&heap);
+    p = arena_alloc_aligned(&heap, 64, 64);
+    if (heap.size < 4096 || !p || ((uintptr_t) p & 63))
+        n_bad++;
+    arena_reset(&heap, 0);
+
+    TEST_LOGGER("  heap bytes: ");
+    print_dec(heap.size);
+    report_mismatches(n_bad);
+}
+
+/* bf16_add_n on heap buffers far larger than the static TP_MAX arrays;
+ * sizes the heap cannot hold are skipped */
+
+static uint16_t *arena_a, *arena_b, *arena_out;
+static uint32_t arena_n;
+
+static void run_arena_add_n(void)
+{
+    bf16_add_n(arena_out, arena_a, arena_b, arena_n);
+}
+
+static const struct bench_case arena_cases[] = {
+    {.name = "bf16_add_n 4096", .run = run_arena_add_n, .ops = 4096,
+     .bytes = 6 * 4096},
+    {.name = "bf16_add_n 16384", .run = run_arena_add_n, .ops = 16384,
+     .bytes = 6 * 16384, .reps = 1},
+    {.name = "bf16_add_n 65536", .run = run_arena_add_n, .ops = 65536,
+     .bytes = 6 * 65536, .reps = 1},
+};
+
+static void test_arena_bench(void)
+{
+    const unsigned n = sizeof(arena_cases) / sizeof(arena_cases[0]);
+    size_t mark = arena_mark(&heap);
+
+    bench_header("arena");
+    for (unsigned i = 0; i < n; i++) {
+        size_t scope = arena_mark(&heap);
+        struct bench_stats st;
+
+        arena_n = arena_cases[i].ops;
+        arena_a = arena_alloc_aligned(&heap, 2 * arena_n, 16);
+        arena_b = arena_alloc_aligned(&heap, 2 * arena_n, 16);
+        arena_out = arena_alloc_aligned(&heap, 2 * arena_n, 16);
+        if (!arena_a || !arena_b || !arena_out) {
+            arena_reset(&heap, scope);
+            continue;
+        }
+        for (uint32_t k = 0; k < arena_n; k++) {
+            arena_a[k] = 0x3f80 | ((k * 29) & 0x7f);
+            arena_b[k] = 0x4000 | ((k * 71) & 0x7f) | ((k & 1) << 15);
+        }
+        bench_measure(&arena_cases[i], &st);
+        bench_report("arena", &arena_cases[i], &st);
+        arena_reset(&heap, scope);
+    }
+    arena_reset(&heap, mark);
+    TEST_LOGGER("  heap peak bytes: ");
+    print_dec(arena_peak(&heap));
+}
+
+/* ============= mem* ============= */
+#define MEM_BUF 4160
+
+static uint8_t mem_buf[MEM_BUF], mem_ref[MEM_BUF], mem_src[MEM_BUF];
+
+static void mem_fill(uint8_t *p, uint32_t n, uint32_t seed)
+{
+    for (uint32_t i = 0; i < n; i++)
+        p[i] = xorshift32(&seed);
+}
+
+/* there is no libc memcmp on bare metal */
+static bool mem_same(const uint8_t *a, const uint8_t *b, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        if (a[i] != b[i])
+            return false;
+    }
+    return true;
+}
+
+/* every length below 80 and a few longer ones, at all 16 alignment pairs,
+ * against a byte loop; guard bytes around the destination must survive
+ * and memmove must get overlap in both directions right */
+static void test_mem(void)
+{
+    uint32_t n_bad = 0;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: memcpy / memset / memmove\n");
+
+    for (uint32_t n = 0; n < 300; n += (n < 80) ? 1 : 37) {
+        for (uint32_t d = 0; d < 4; d++) {
+            for (uint32_t s = 0; s < 4; s++) {
+                uint8_t *dst = mem_buf + 64 + d;
+                uint32_t i;
+
+                mem_fill(mem_buf, 512, n * 16 + d * 4 + s + 1);
+                mem_fill(mem_src, 512, n + 99);
+                for (i = 0; i < 512; i++)
+                    mem_ref[i] = mem_buf[i];
+                if (memcpy(dst, mem_src + s, n) != dst)
+                    n_bad++;
+                for (i = 0; i < n; i++)
+                    mem_ref[64 + d + i] = mem_src[s + i];
+                if (!mem_same(mem_ref, mem_buf, 512))
+                    n_bad++;
+
+                if (memset(dst, 0x15A + s, n) != dst)
+                    n_bad++;
+                for (i = 0; i < n; i++)
+                    mem_ref[64 + d + i] = 0x15A + s;
+                if (!mem_same(mem_ref, mem_buf, 512))
+                    n_bad++;
+
+                /* source ahead of dest (forward), then behind it */
+                for (int back = 0; back < 2; back++) {
+                    uint8_t *src = back ? dst - 1 - s : dst + 1 + s;
+                    uint32_t from = src - mem_buf, to = dst - mem_buf;
+
+                    if (memmove(dst, src, n) != dst)
+                        n_bad++;
+                    if (back) {
+                        for (i = n; i-- > 0;)
+                            mem_ref[to + i] = mem_ref[from + i];
+                    }
+                    else {
+                        for (i = 0; i < n; i++)
+                            mem_ref[to + i] = mem_ref[from + i];
+                    }
+                    if (!mem_same(mem_ref, mem_buf, 512))
+                        n_bad++;
+                }
+            }
+        }
+    }
+    report_mismatches(n_bad);
+}
+
+/* bytes per cycle: size sweep with both sides aligned, then the source
+ * (or memmove's overlap) off by one and three */
+static uint32_t mem_n, mem_src_off;
+
+static void run_memcpy(void)
+{
+    memcpy(mem_buf, mem_src + mem_src_off, mem_n);
+}
+
+static void run_memset(void)
+{
+    memset(mem_buf + mem_src_off, 0, mem_n);
+}
+
+/* backward: the source starts below the destination */
+static void run_memmove(void)
+{
+    memmove(mem_buf + 64, mem_buf + mem_src_off, mem_n);
+}
+
+static const struct bench_case mem_cases[] = {
+    {.name = "memcpy 16", .run = run_memcpy, .bytes = 2 * 16},
+    {.name = "memcpy 256", .run = run_memcpy, .bytes = 2 * 256},
+    {.name = "memcpy 4096", .run = run_memcpy, .bytes = 2 * 4096},
+    {.name = "memcpy 4096 src+1", .run = run_memcpy, .bytes = 2 * 4096},
+    {.name = "memcpy 4096 src+3", .run = run_memcpy, .bytes = 2 * 4096},
+    {.name = "memset 16", .run = run_memset, .bytes = 16},
+    {.name = "memset 256", .run = run_memset, .bytes = 256},
+    {.name = "memset 4096", .run = run_memset, .bytes = 4096},
+    {.name = "memset 4096 dst+1", .run = run_memset, .bytes = 4096},
+    {.name = "memmove 256 back", .run = run_memmove, .bytes = 2 * 256},
+    {.name = "memmove 4096 back", .run = run_memmove, .bytes = 2 * 4096},
+    {.name = "memmove 4096 back+1", .run = run_memmove,
+     .bytes = 2 * 4096},
+};
+/* length and source offset of each case */
+static const uint16_t mem_shape[][2] = {
+    {16, 0}, {256, 0}, {4096, 0}, {4096, 1}, {4096, 3},
+    {16, 0}, {256, 0}, {4096, 0}, {4096, 1},
+    {256, 0}, {4096, 0}, {4096, 1},
+};
+
+static void test_mem_bench(void)
+{
+    const unsigned n = sizeof(mem_cases) / sizeof(mem_cases[0]);
+
+    bench_header("mem");
+    for (unsigned i = 0; i < n; i++) {
+        struct bench_stats st;
+
+        mem_n = mem_shape[i][0];
+        mem_src_off = mem_shape[i][1];
+        bench_measure(&mem_cases[i], &st);
+        bench_report("mem", &mem_cases[i], &st);
+    }
+}
+
+/* ============= File Batch Mode ============= */
+/* Input records are 8 bytes, little-endian: op, a, b, c. The output file
+ * gets one bf16 result per record: a + b, a * b or hero(a, b, c); an
+ * unknown op gives 0. Any batch.in next to the emulator is streamed to
+ * batch.out, the self-test writes its own input first. */
+#define BATCH_IN "batch.in"
+#define BATCH_OUT "batch.out"
+#define BATCH_SELF_IN "batch_selftest.in"
+#define BATCH_SELF_OUT "batch_selftest.out"
+#define BATCH_SELF_N 3000
+
+enum { BATCH_ADD, BATCH_MUL, BATCH_HERO };
+
+struct batch_rec {
+    uint16_t op, a, b, c;
+};
+
+static uint32_t batch_seed;
+
+static struct batch_rec batch_gen(void)
+{
+    struct batch_rec r;
+
+    xorshift32(&batch_seed);
+    r.op = batch_seed & 3; /* 3: unknown */
+    r.a = 0x3D00 + ((batch_seed >> 2) & 0x4FF);
+    r.b = 0x3D00 + ((batch_seed >> 12) & 0x4FF);
+    r.c = 0x3D00 + ((batch_seed >> 20) & 0x4FF);
+    return r;
+}
+
+static uint16_t batch_apply(const struct batch_rec *r)
+{
+    bf16_t a = {r->a}, b = {r->b}, c = {r->c};
+
+    switch (r->op) {
+    case BATCH_ADD:
+        return my_add(r->a, r->b, 0, 25, 7, 15);
+    case BATCH_MUL:
+        return my_fp_mul(r->a, r->b, 0, 25, 7, 15, 15);
+    case BATCH_HERO:
+        return hero(a, b, c);
+    default:
+        return 0;
+    }
+}
+
+/* in -> out through chunk-byte reader buffers and a writer of the same
+ * size, all from the heap arena and given back afterwards; the record
+ * count, or -1 when a file or the heap fails */
+static long batch_run(const char *in, const char *out, size_t chunk)
+{
+    size_t mark = arena_mark(&heap);
+    struct fio_reader rd;
+    struct fio_writer wr;
+    const struct batch_rec *rec;
+    uint16_t *res;
+    uint32_t n;
+    long total = 0;
+    int fd_in, fd_out;
+
+    fd_in = fio_open(in, FIO_READ);
+    if (fd_in < 0)
+        return -1;
+    fd_out = fio_open(out, FIO_WRITE);
+    res = arena_alloc(&heap, chunk / 4);
+    if (fd_out < 0 || !res ||
+        fio_reader_init(&rd, fd_in, &heap, chunk, sizeof(*rec)) ||
+        fio_writer_init(&wr, fd_out, &heap, chunk)) {
+        total = -1;
+        goto done;
+    }
+    while ((rec = fio_reader_next(&rd, &n))) {
+        for (uint32_t i = 0; i < n; i++)
+            res[i] = batch_apply(&rec[i]);
+        if (fio_writer_put(&wr, res, 2 * n)) {
+            total = -1;
+            goto done;
+        }
+        total += n;
+    }
+    if (fio_writer_flush(&wr))
+        total = -1;
+done:
+    if (fd_out >= 0)
+        fio_close(fd_out);
+    fio_close(fd_in);
+    arena_reset(&heap, mark);
+    return total;
+}
+
+/* BATCH_SELF_N generated records, written in 512-byte pieces, streamed
+ * with chunk sizes of whole records (64, 4096) and with 1004, which ends
+ * every chunk 4 bytes into a record; every result read back must match a
+ * direct kernel call */
+static const uint16_t batch_chunks[] = {64, 1004, 4096};
+
+/* the cut-record hand-off alone: a 12-byte reader holds one 8-byte
+ * record and half of the next, so every chunk after the first starts
+ * with a carried half; the records must come back whole and in order */
+static uint32_t batch_reader_check(void)
+{
+    uint32_t n_bad = 0, i = 0, n, cuts = 0;
+    struct fio_reader rd;
+    const struct batch_rec *rec;
+    size_t mark = arena_mark(&heap);
+    int fd = fio_open(BATCH_SELF_IN, FIO_READ);
+
+    if (fd < 0 || fio_reader_init(&rd, fd, &heap, 12, sizeof(*rec))) {
+        if (fd >= 0)
+            fio_close(fd);
+        return 1;
+    }
+    batch_seed = 0x2545F491;
+    while ((rec = fio_reader_next(&rd, &n))) {
+        if (rd.carry)
+            cuts++;
+        for (uint32_t k = 0; k < n; k++, i++) {
+            struct batch_rec r = batch_gen();
+
+            if (rec[k].op != r.op || rec[k].a != r.a || rec[k].b != r.b ||
+                rec[k].c != r.c)
+                n_bad++;
+        }
+    }
+    fio_close(fd);
+    arena_reset(&heap, mark);
+    return n_bad + (i != BATCH_SELF_N) + (cuts == 0);
+}
+
+static uint32_t batch_check(void)
+{
+    uint32_t n_bad = 0, i = 0, n;
+    struct fio_reader rd;
+    const uint16_t *res;
+    size_t mark = arena_mark(&heap);
+    int fd = fio_open(BATCH_SELF_OUT, FIO_READ);
+
+    /* 255 bytes: results are cut too */
+    if (fd < 0 || fio_reader_init(&rd, fd, &heap, 255, 2)) {
+        if (fd >= 0)
+            fio_close(fd);
+        return 1;
+    }
+    batch_seed = 0x2545F491;
+    while ((res = fio_reader_next(&rd, &n))) {
+        for (uint32_t k = 0; k < n; k++, i++) {
+            struct batch_rec r = batch_gen();
+
+            if (res[k] != batch_apply(&r))
+                n_bad++;
+        }
+    }
+    fio_close(fd);
+    arena_reset(&heap, mark);
+    return n_bad + (i != BATCH_SELF_N);
+}
+
+static void test_batch(void)
+{
+    const unsigned n_chunks = sizeof(batch_chunks) / sizeof(batch_chunks[0]);
+    size_t mark = arena_mark(&heap);
+    struct fio_writer wr;
+    uint32_t n_bad = 0;
+    int fd;
+
+    TEST_LOGGER("--------------------\n");
+    TEST_LOGGER("Test: file batch mode\n");
+
+    fd = fio_open(BATCH_SELF_IN, FIO_WRITE);
+    if (fd < 0 || fio_writer_init(&wr, fd, &heap, 512)) {
+        TEST_LOGGER("  cannot write " BATCH_SELF_IN "\tFAILED\n");
+        if (fd >= 0)
+            fio_close(fd);
+        return;
+    }
+    batch_seed = 0x2545F491;
+    for (uint32_t i = 0; i < BATCH_SELF_N; i++) {
+        struct batch_rec r = batch_gen();
+
+        if (fio_writer_put(&wr, &r, sizeof(r)))
+            n_bad++;
+    }
+    if (fio_writer_flush(&wr))
+        n_bad++;
+    fio_close(fd);
+    arena_reset(&heap, mark);
+
+    n_bad += batch_reader_check();
+    for (unsigned i = 0; i < n_chunks; i++) {
+        if (batch_run(BATCH_SELF_IN, BATCH_SELF_OUT, batch_chunks[i]) !=
+            BATCH_SELF_N)
+            n_bad++;
+        n_bad += batch_check();
+    }
+    report_mismatches(n_bad);
+}
+
+/* end to end, open to close, cycles per record; then batch.in if any */
+static size_t batch_chunk;
+
+static void run_batch(void)
+{
+    bench_sink = batch_run(BATCH_SELF_IN, BATCH_SELF_OUT, batch_chunk);
+}
+
+static const struct bench_case batch_cases[] = {
+    {.name = "batch chunk 64", .run = run_batch, .ops = BATCH_SELF_N,
+     .reps = 1},
+    {.name = "batch chunk 1004", .run = run_batch, .ops = BATCH_SELF_N,
+     .reps = 1},
+    {.name = "batch chunk 4096", .run = run_batch, .ops = BATCH_SELF_N,
+     .reps = 1},
+};
+
+static void test_batch_bench(void)
+{
+    const unsigned n = sizeof(batch_cases) / sizeof(batch_cases[0]);
+    uint64_t start;
+    long recs;
+
+    bench_header("batch");
+    for (unsigned i = 0; i < n; i++) {
+        struct bench_stats st;
+
+        batch_chunk = batch_chunks[i];
+        bench_measure(&batch_cases[i], &st);
+        bench_report("batch", &batch_cases[i], &st);
+    }
+
+    start = get_cycles();
+    recs = batch_run(BATCH_IN, BATCH_OUT, 65536);
+    if (recs < 0) {
+        TEST_LOGGER("  no " BATCH_IN "\n");
+        return;
+    }
+    start = get_cycles() - start;
+    TEST_LOGGER("  " BATCH_IN " -> " BATCH_OUT ": records ");
+    print_dec_end(recs, ',');
+    TEST_LOGGER(" cycles ");
+    out_u64(start, 0, FMT_COMMA);
+    out_putc('\n');
+}
+
+/* ============= Tracing ============= */
+/* hero between two C probes: the ring must end with the C exit and,
+ * walking back, hold balanced enter/exit pairs down to the C enter with
+ * hero's own enter right after it */
+static void test_trace(void)
+{
+    TEST_LOGGER("--------------------\n");
+#ifdef TRACE
+    bf16_t a = {0x4040}, b = {0x4080}, c = {0x40A0};
+    const struct trace_rec *r;
+    uint32_t start = trace_log.hits, n, n_bad = 0, tag = 0, next = 0;
+    int32_t depth = 0;
+
+    TEST_LOGGER("Test: trace probes around hero\n");
+    TRACE_ENTER(TRACE_ID_USER);
+    hero(a, b, c);
+    TRACE_EXIT(TRACE_ID_USER);
+    n = trace_log.hits - start;
+
+    r = (const void *) ((const uint8_t *) trace_log.rec + trace_head());
+    if (n < 4 || n > TRACE_RECORDS)
+        n_bad++;
+    for (uint32_t i = 0; i < n && !n_bad; i++) {
+        if (r == trace_log.rec)
+            r += TRACE_RECORDS;
+        r--;
+        next = tag;
+        tag = r->tag;
+        if (i == 0 && tag != (TRACE_ID_USER << 2 | TRACE_KIND_EXIT))
+            n_bad++;
+        if ((tag & 3) == TRACE_KIND_EXIT)
+            depth++;
+        else if ((tag & 3) == TRACE_KIND_ENTER && --depth < 0)
+            n_bad++;
+    }
+    if (depth || tag != (TRACE_ID_USER << 2 | TRACE_KIND_ENTER) ||
+        next != (TRACE_ID_HERO << 2 | TRACE_KIND_ENTER))
+        n_bad++;
+    TEST_LOGGER("  probes: ");
+    print_dec(n);
+    report_mismatches(n_bad);
+#else
+    TEST_LOGGER("Test: trace probes (off, build with TRACE=1)\n");
+#endif
+}
+
 int main(void)
 {
     test_hanoi();
     test_rsqrt();
+    test_bf16_rsqrt();
+    test_mul_bench();
+    test_fmt_bench();
     test_my_bfloat16();
+    test_bf16_conformance();
+    test_bf16_throughput();
+    test_bf16_convert_n();
+    test_bf16_convert_bench();
+    test_bf16x2_ops();
+    test_bf16x2_bench();
+    test_bf16_fma();
+    test_bf16_fma_bench();
+    test_bf16_linalg();
+    test_bf16_linalg_bench();
+    test_bf16_math();
+    test_bf16_math_bench();
+    test_q16();
+    test_q16_bench();
     test_hanoi();
+    test_hanoi_engine();
+    test_hanoi_bench();
     test_hero();
+    test_hero_n();
+    test_hero_bench();
+    test_kernel_bench();
+    test_class_bench();
+    test_mem();
+    test_mem_bench();
+    test_arena();
+    test_arena_bench();
+    test_batch();
+    test_batch_bench();
+    test_trace();
     return 0;
 }
\ No newline at end of file
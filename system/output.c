@@ -0,0 +1,123 @@
+#include <stdbool.h>
+#include <stddef.h>
+#ifdef HOST_BUILD
+#include <unistd.h>
+#endif
+
+#include "fmt.h"
+#include "output.h"
+
+#define OUT_BUF_SIZE 256
+
+static char out_buf[OUT_BUF_SIZE];
+static size_t out_len;
+static enum out_mode out_cur_mode = OUT_LINE;
+static unsigned long out_ecall_count;
+
+/* write(1, ptr, length) */
+static void out_sys_write(const char *ptr, size_t length)
+{
+#ifdef HOST_BUILD
+    while (length) {
+        ssize_t n = write(1, ptr, length);
+
+        if (n <= 0)
+            break;
+        ptr += n;
+        length -= n;
+    }
+#else
+    asm volatile(
+        "li a7, 0x40;"
+        "li a0, 0x1;" /* stdout */
+        "mv a1, %0;"
+        "mv a2, %1;" /* length character */
+        "ecall;"
+        :
+        : "r"(ptr), "r"(length)
+        : "a0", "a1", "a2", "a7", "memory");
+#endif
+    out_ecall_count++;
+}
+
+void out_flush(void)
+{
+    if (out_len == 0)
+        return;
+    out_sys_write(out_buf, out_len);
+    out_len = 0;
+}
+
+void out_set_mode(enum out_mode mode)
+{
+    out_flush();
+    out_cur_mode = mode;
+}
+
+unsigned long out_ecalls(void)
+{
+    return out_ecall_count;
+}
+
+void out_write(const char *s, size_t n)
+{
+    bool newline = false;
+
+    if (out_cur_mode == OUT_UNBUFFERED) {
+        out_flush();
+        if (n)
+            out_sys_write(s, n);
+        return;
+    }
+
+    while (n--) {
+        char c = *s++;
+
+        out_buf[out_len++] = c;
+        if (out_len == OUT_BUF_SIZE)
+            out_flush();
+        if (c == '\n')
+            newline = true;
+    }
+    if (newline && out_cur_mode == OUT_LINE)
+        out_flush();
+}
+
+void out_putc(char c)
+{
+    out_write(&c, 1);
+}
+
+void out_puts(const char *s)
+{
+    const char *end = s;
+
+    while (*end)
+        end++;
+    out_write(s, end - s);
+}
+
+void out_dec(unsigned long val)
+{
+    out_u64(val, 0, 0);
+}
+
+void out_u64(uint64_t val, unsigned width, unsigned flags)
+{
+    char buf[FMT_U64_MAX];
+
+    out_write(buf, fmt_u64(buf, val, width, flags));
+}
+
+void out_hex(unsigned long val)
+{
+    char buf[2 * sizeof(val)]; /* 8 digits on rv32, 16 on a 64-bit host */
+    char *p = buf + sizeof(buf);
+
+    do {
+        int digit = val & 0xf;
+        *--p = (digit < 10) ? ('0' + digit) : ('a' + digit - 10);
+        val >>= 4;
+    } while (val);
+    out_write(p, buf + sizeof(buf) - p);
+}
@@ -0,0 +1,35 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Buffered console output (output.c). Everything written through here is
+ * collected in a static buffer and handed to the host with one write
+ * ecall per flush instead of one per fragment.
+ *
+ * The buffer is flushed when it fills up, on '\n' in OUT_LINE mode, by
+ * out_flush() and by start.S before the exit ecall (portable/start.c on
+ * host builds). All functions follow the standard calling convention and
+ * can be called from assembly.
+ */
+enum out_mode {
+    OUT_UNBUFFERED, /* one ecall per call, as the old printstr did */
+    OUT_LINE,       /* flush on newline (default) */
+    OUT_FULL,       /* flush only when full or on out_flush() */
+};
+
+void out_set_mode(enum out_mode mode);
+void out_write(const char *s, size_t n);
+void out_putc(char c);
+void out_puts(const char *s);
+void out_dec(unsigned long val);
+/* Full 64-bit decimal, width/flags as for fmt_u64 (fmt.h) */
+void out_u64(uint64_t val, unsigned width, unsigned flags);
+void out_hex(unsigned long val);
+void out_flush(void);
+
+/* Number of write ecalls issued so far */
+unsigned long out_ecalls(void);
+
+#endif /* OUTPUT_H */
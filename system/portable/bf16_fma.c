@@ -0,0 +1,109 @@
+/* C twin of bf16_fma.S: the same fixed-point datapath, step for step */
+#include <stdint.h>
+
+#include "bfloat16.h"
+
+#define BF16_QNAN 0x7FC0
+
+/* mantissa with the hidden bit at bit 7; subnormals are normalized and
+ * their exponent drops below 1 */
+static uint32_t fma_unpack(uint32_t x, int32_t *exp)
+{
+    int32_t e = (x >> 7) & 0xFF;
+    uint32_t m = x & 0x7F;
+
+    if (e)
+        m |= 0x80;
+    else
+        for (e = 1; !(m & 0x80); e--)
+            m <<= 1;
+    *exp = e;
+    return m;
+}
+
+/* x >> sh with the shifted-out bits jammed into bit 0 */
+static uint32_t fma_shr_jam(uint32_t x, uint32_t sh)
+{
+    if (sh > 31)
+        return x != 0;
+    return (x >> sh) | ((x >> sh) << sh != x);
+}
+
+uint32_t bf16_fma(const uint32_t in1, const uint32_t in2, const uint32_t in3)
+{
+    uint32_t sp = (in1 ^ in2) & 0x8000, sc = in3 & 0x8000;
+    uint32_t ta = in1 << 17, tb = in2 << 17, tc = in3 << 17;
+    uint32_t x, y, t, m, rest;
+    int32_t ea, eb, ec, l, d;
+
+    if (ta > 0xFF000000)
+        return in1;
+    if (tb > 0xFF000000)
+        return in2;
+    if (tc > 0xFF000000)
+        return in3;
+    if (ta == 0xFF000000 || tb == 0xFF000000) {
+        if (!ta || !tb || (tc == 0xFF000000 && sc != sp))
+            return BF16_QNAN;
+        return sp | 0x7F80;
+    }
+    if (tc == 0xFF000000)
+        return in3;
+    if (!ta || !tb)
+        return tc ? in3 : sp & sc;
+
+    /* both terms on one scale, 2^(exponent - 156): the product at bits
+     * 28..29, the addend at bit 29 */
+    x = fma_unpack(in1, &ea) * fma_unpack(in2, &eb) << 14;
+    l = ea + eb - 126;
+    if (tc) {
+        y = fma_unpack(in3, &ec) << 22;
+        d = l - ec;
+        if (d < 0) {
+            t = x;
+            x = y;
+            y = t;
+            t = sp;
+            sp = sc;
+            sc = t;
+            l = ec;
+            d = -d;
+        }
+        y = fma_shr_jam(y, d);
+        if (sp == sc) {
+            x += y;
+        }
+        else if (x >= y) {
+            x -= y;
+        }
+        else {
+            x = y - x;
+            sp = sc;
+        }
+        if (!x)
+            return 0;
+    }
+
+    /* leading bit to bit 31, round at bit 24 */
+    l += 2;
+    while (!(x & 0x80000000)) {
+        x <<= 1;
+        l--;
+    }
+    if (l >= 0xFF)
+        return sp | 0x7F80;
+    if (l <= 0) {
+        x = fma_shr_jam(x, 1 - l);
+        l = 1;
+    }
+    m = x >> 24;
+    rest = x << 8;
+    if (rest + (m & 1) > 0x80000000)
+        m++;
+    return sp | (((uint32_t) (l - 1) << 7) + m);
+}
+
+uint32_t bf16_fms(const uint32_t in1, const uint32_t in2, const uint32_t in3)
+{
+    return bf16_fma(in1, in2, in3 ^ 0x8000);
+}
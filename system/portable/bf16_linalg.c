@@ -0,0 +1,73 @@
+/* C twin of bf16_linalg.S. The assembly blocks and tiles its loops, but
+ * every output is still summed in index order from +0, so the plain loops
+ * here give the same bits. */
+#include <stdint.h>
+
+#include "bfloat16.h"
+
+uint32_t bf16_mul_f32(const uint32_t in1, const uint32_t in2)
+{
+    uint32_t sign = ((in1 ^ in2) & 0x8000) << 16;
+    uint32_t ta = in1 << 17, tb = in2 << 17, ma, mb, m;
+    int32_t ea, eb, e;
+
+    if (ta > 0xFF000000)
+        return in1 << 16;
+    if (tb > 0xFF000000)
+        return in2 << 16;
+    if (ta == 0xFF000000 || tb == 0xFF000000)
+        return (!ta || !tb) ? 0x7FC00000 : sign | 0x7F800000;
+    if (!ta || !tb)
+        return sign;
+
+    /* subnormals are normalised into the exponent */
+    ea = ta >> 24;
+    ma = (in1 & 0x7F) | 0x80;
+    if (!ea)
+        for (ea = 1, ma = in1 & 0x7F; !(ma & 0x80); ea--)
+            ma <<= 1;
+    eb = tb >> 24;
+    mb = (in2 & 0x7F) | 0x80;
+    if (!eb)
+        for (eb = 1, mb = in2 & 0x7F; !(mb & 0x80); eb--)
+            mb <<= 1;
+
+    m = ma * mb;
+    e = ea + eb - 127 + (m >> 15);
+    m <<= (m >> 15) ? 8 : 9; /* hidden bit at bit 23 */
+    if (e >= 0xFF)
+        return sign | 0x7F800000;
+    if (e <= 0)
+        return sign | ((1 - e) < 24 ? m >> (1 - e) : 0);
+    return sign | (uint32_t) e << 23 | (m & 0x7FFFFF);
+}
+
+uint32_t bf16_dot(const uint16_t *x, const uint16_t *y, uint32_t n)
+{
+    uint32_t acc = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+        acc = f32_add(acc, bf16_mul_f32(x[i], y[i]));
+    return acc;
+}
+
+void bf16_gemv(uint32_t *y, const uint16_t *a, const uint16_t *x, uint32_t m,
+               uint32_t n)
+{
+    for (uint32_t i = 0; i < m; i++)
+        y[i] = bf16_dot(a + i * n, x, n);
+}
+
+void bf16_gemm(uint32_t *c, const uint16_t *a, const uint16_t *b, uint32_t m,
+               uint32_t n, uint32_t k)
+{
+    for (uint32_t i = 0; i < m; i++) {
+        for (uint32_t j = 0; j < n; j++) {
+            uint32_t acc = 0;
+
+            for (uint32_t p = 0; p < k; p++)
+                acc = f32_add(acc, bf16_mul_f32(a[i * k + p], b[p * n + j]));
+            c[i * n + j] = acc;
+        }
+    }
+}
@@ -0,0 +1,208 @@
+/* C twin of bf16_math.S: the same tables and fixed-point steps */
+#include <stdint.h>
+
+#include "bfloat16.h"
+
+#define BF16_QNAN 0x7FC0
+#define BF16_ONE 0x3F80
+
+/* bf16_tables.S, generated by bf16_tablegen.c */
+extern const int8_t bf16_recip_table[128];
+extern const uint32_t bf16_exp_table[128];
+extern const uint32_t bf16_log2_table[128];
+extern const uint32_t bf16_exp2_knots[65];
+extern const uint32_t bf16_recip_knots[66];
+
+/* v * 2^e (v > 0) to bf16, round to nearest even; subnormal results flush
+ * to zero, overflow gives inf */
+static uint32_t math_pack(uint32_t sign, uint32_t v, int32_t e)
+{
+    uint32_t mant, round;
+    int32_t bits;
+
+    e += 127 + 31;
+    while (!(v & 0x80000000)) {
+        v <<= 1;
+        e--;
+    }
+    if (e >= 0xFF)
+        return sign | 0x7F80;
+    if (e < 0)
+        return sign;
+    mant = v >> 24;
+    round = (v << 8) + (mant & 1);
+    mant += round > 0x80000000;
+    bits = ((e - 1) << 7) + (int32_t) mant; /* hidden bit and carry in exp */
+    if (bits < 0x80)
+        return sign;
+    return sign | bits;
+}
+
+/* 2^(y / 2^22) as r * 2^n, r in [2^23, 2^24): one multiply between knots */
+static uint32_t math_exp2(int32_t y, int32_t *n)
+{
+    uint32_t f = y & 0x3FFFFF, i = f >> 16, w = (f >> 4) & 0xFFF;
+    uint32_t d = bf16_exp2_knots[i + 1] - bf16_exp2_knots[i];
+
+    *n = y >> 22;
+    return bf16_exp2_knots[i] + ((d * w) >> 12);
+}
+
+/* 2^24 / (1 + u), u = U / 2^30 in [0, 1]; the knots fall */
+static uint32_t math_recip1p(uint32_t u)
+{
+    uint32_t i = u >> 24, w = (u >> 12) & 0xFFF;
+    uint32_t d = bf16_recip_knots[i] - bf16_recip_knots[i + 1];
+
+    return bf16_recip_knots[i] - ((d * w) >> 12);
+}
+
+/* (1 + m/128) * 2^e * log2(e), Q22 */
+static int32_t math_scale(uint32_t mant, int32_t e)
+{
+    uint32_t y = bf16_exp_table[mant];
+
+    return e >= 0 ? y << e : y >> -e;
+}
+
+uint32_t bf16_exp(const uint32_t in)
+{
+    uint32_t exp = (in >> 7) & 0xFF, sign = in & 0x8000, r;
+    int32_t e = (int32_t) exp - 127, y, n;
+
+    if (exp == 0xFF) {
+        if (in & 0x7F)
+            return in;
+        return sign ? 0 : 0x7F80;
+    }
+    if (e <= -10) /* also +-0 and subnormals */
+        return BF16_ONE;
+    if (e >= 7)
+        return sign ? 0 : 0x7F80;
+    y = math_scale(in & 0x7F, e);
+    if (sign)
+        y = -y;
+    r = math_exp2(y, &n);
+    return math_pack(0, r, n - 23);
+}
+
+uint32_t bf16_log2(const uint32_t in)
+{
+    uint32_t exp = (in >> 7) & 0xFF, sign = 0;
+    int32_t y;
+
+    if (exp == 0xFF) {
+        if (in & 0x7F)
+            return in;
+        return (in & 0x8000) ? BF16_QNAN : 0x7F80;
+    }
+    if (exp == 0)
+        return 0xFF80;
+    if (in & 0x8000)
+        return BF16_QNAN;
+    y = (((int32_t) exp - 127) << 22) + bf16_log2_table[in & 0x7F];
+    if (y == 0)
+        return 0;
+    if (y < 0) {
+        sign = 0x8000;
+        y = -y;
+    }
+    return math_pack(sign, y, -22);
+}
+
+uint32_t bf16_recip(const uint32_t in)
+{
+    uint32_t exp = (in >> 7) & 0xFF, sign = in & 0x8000;
+    int32_t v;
+
+    if (exp == 0xFF) {
+        if (in & 0x7F)
+            return in;
+        return sign;
+    }
+    if (exp == 0)
+        return sign | 0x7F80;
+    v = ((254 - (int32_t) exp) << 7) + bf16_recip_table[in & 0x7F];
+    if (v < 0x80)
+        return sign;
+    return sign | v;
+}
+
+/* u = e^-|x| = r * 2^n; 1/(1 + u) for x >= 0 and u/(1 + u) below */
+uint32_t bf16_sigmoid(const uint32_t in)
+{
+    uint32_t exp = (in >> 7) & 0xFF, sign = in & 0x8000, r, q;
+    int32_t e = (int32_t) exp - 127, n;
+
+    if (exp == 0xFF) {
+        if (in & 0x7F)
+            return in;
+        return sign ? 0 : BF16_ONE;
+    }
+    if (e <= -9) /* also +-0 and subnormals */
+        return 0x3F00;
+    if (e >= 3 && !sign)
+        return BF16_ONE;
+    if (e >= 7)
+        return 0;
+    r = math_exp2(-math_scale(in & 0x7F, e), &n);
+    if (n < -30)
+        return math_pack(0, r, n - 23);
+    q = math_recip1p((r << 7) >> -n);
+    if (!sign)
+        return math_pack(0, q, -24);
+    return math_pack(0, (r >> 8) * (q >> 8), n - 15 - 16);
+}
+
+/* u = e^-2|x|: (1 - u) / (1 + u) */
+uint32_t bf16_tanh(const uint32_t in)
+{
+    uint32_t exp = (in >> 7) & 0xFF, sign = in & 0x8000, r, u, q;
+    int32_t e = (int32_t) exp - 127, n;
+
+    if (exp == 0xFF) {
+        if (in & 0x7F)
+            return in;
+        return sign | BF16_ONE;
+    }
+    if (exp == 0)
+        return sign;
+    if (e <= -5)
+        return in;
+    if (e >= 2)
+        return sign | BF16_ONE;
+    r = math_exp2(-math_scale(in & 0x7F, e + 1), &n);
+    u = (r << 7) >> -n;
+    q = math_recip1p(u);
+    return math_pack(sign, ((0x40000000 - u) >> 12) * (q >> 10), -32);
+}
+
+void bf16_exp_n(uint16_t *dst, const uint16_t *a, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = bf16_exp(a[i]);
+}
+
+void bf16_log2_n(uint16_t *dst, const uint16_t *a, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = bf16_log2(a[i]);
+}
+
+void bf16_recip_n(uint16_t *dst, const uint16_t *a, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = bf16_recip(a[i]);
+}
+
+void bf16_sigmoid_n(uint16_t *dst, const uint16_t *a, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = bf16_sigmoid(a[i]);
+}
+
+void bf16_tanh_n(uint16_t *dst, const uint16_t *a, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = bf16_tanh(a[i]);
+}
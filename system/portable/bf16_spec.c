@@ -0,0 +1,105 @@
+/* C twin of bf16_spec.S: the generic kernels with the offsets fixed */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bfloat16.h"
+
+bool bf16_is_nan(const uint32_t in)
+{
+    return is_nan(in, 0, 0, 25, 7);
+}
+
+bool bf16_is_inf(const uint32_t in)
+{
+    return is_inf(in, 0, 0, 25, 7);
+}
+
+bool bf16_is_zero(const uint32_t in)
+{
+    return is_zero(in, 0, 0, 17);
+}
+
+bool bf16_eq(const uint32_t in1, const uint32_t in2)
+{
+    return is_eq(in1, in2, 0, 25, 7, 15);
+}
+
+bool bf16_lt(const uint32_t in1, const uint32_t in2)
+{
+    return is_lt(in1, in2, 0, 25, 7, 15);
+}
+
+bool bf16_gt(const uint32_t in1, const uint32_t in2)
+{
+    return is_gt(in1, in2, 0, 25, 7, 15);
+}
+
+uint32_t bf16_add(const uint32_t in1, const uint32_t in2)
+{
+    return my_add(in1, in2, 0, 25, 7, 15);
+}
+
+uint32_t bf16_sub(const uint32_t in1, const uint32_t in2)
+{
+    return my_sub(in1, in2, 0, 25, 7, 15);
+}
+
+uint32_t bf16_mul(const uint32_t in1, const uint32_t in2)
+{
+    return my_fp_mul(in1, in2, 0, 25, 7, 15, 15);
+}
+
+uint32_t bf16_div(const uint32_t in1, const uint32_t in2)
+{
+    return my_div(in1, in2, 0, 25, 7, 15, 15);
+}
+
+bool f32_is_nan(const uint32_t in)
+{
+    return is_nan(in, 0, 0, 9, 23);
+}
+
+bool f32_is_inf(const uint32_t in)
+{
+    return is_inf(in, 0, 0, 9, 23);
+}
+
+bool f32_is_zero(const uint32_t in)
+{
+    return is_zero(in, 0, 0, 1);
+}
+
+bool f32_eq(const uint32_t in1, const uint32_t in2)
+{
+    return is_eq(in1, in2, 0, 9, 23, 31);
+}
+
+bool f32_lt(const uint32_t in1, const uint32_t in2)
+{
+    return is_lt(in1, in2, 0, 9, 23, 31);
+}
+
+bool f32_gt(const uint32_t in1, const uint32_t in2)
+{
+    return is_gt(in1, in2, 0, 9, 23, 31);
+}
+
+uint32_t f32_add(const uint32_t in1, const uint32_t in2)
+{
+    return my_add(in1, in2, 0, 9, 23, 31);
+}
+
+uint32_t f32_sub(const uint32_t in1, const uint32_t in2)
+{
+    return my_sub(in1, in2, 0, 9, 23, 31);
+}
+
+uint32_t f32_mul(const uint32_t in1, const uint32_t in2)
+{
+    return my_fp_mul(in1, in2, 0, 9, 23, 31, 48);
+}
+
+uint32_t f32_div(const uint32_t in1, const uint32_t in2)
+{
+    return my_div(in1, in2, 0, 9, 23, 31, 48);
+}
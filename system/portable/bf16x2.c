@@ -0,0 +1,116 @@
+/* C twin of bf16x2.S, one lane at a time */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bfloat16.h"
+
+static bool lane_nan(uint32_t v)
+{
+    return (v & 0x7FFF) > 0x7F80;
+}
+
+/* sign-magnitude to unsigned: -0 just below +0, NaNs at both ends */
+static uint32_t lane_key(uint32_t v)
+{
+    return (v & 0x8000) ? v ^ 0xFFFF : v | 0x8000;
+}
+
+static uint32_t lane_lt(uint32_t a, uint32_t b)
+{
+    if (lane_nan(a) || lane_nan(b) || ((a | b) & 0x7FFF) == 0)
+        return 0;
+    return lane_key(a) < lane_key(b) ? 0xFFFF : 0;
+}
+
+static uint32_t lane_eq(uint32_t a, uint32_t b)
+{
+    if (lane_nan(a))
+        return 0;
+    return (a == b || ((a | b) & 0x7FFF) == 0) ? 0xFFFF : 0;
+}
+
+/* b when it orders first (min) or last (max), a NaN operand loses */
+static uint32_t lane_pick(uint32_t a, uint32_t b, bool max)
+{
+    bool take_b;
+
+    if (lane_nan(a))
+        take_b = true;
+    else if (lane_nan(b))
+        take_b = false;
+    else if (max)
+        take_b = lane_key(a) < lane_key(b);
+    else
+        take_b = lane_key(b) < lane_key(a);
+    return take_b ? b : a;
+}
+
+static bf16x2_t lanes(uint32_t lo, uint32_t hi)
+{
+    bf16x2_t r = {lo | hi << 16};
+    return r;
+}
+
+bf16x2_t bf16x2_is_nan(const bf16x2_t in)
+{
+    return lanes(lane_nan(in.bits & 0xFFFF) ? 0xFFFF : 0,
+                 lane_nan(in.bits >> 16) ? 0xFFFF : 0);
+}
+
+bf16x2_t bf16x2_is_inf(const bf16x2_t in)
+{
+    return lanes((in.bits & 0x7FFF) == 0x7F80 ? 0xFFFF : 0,
+                 ((in.bits >> 16) & 0x7FFF) == 0x7F80 ? 0xFFFF : 0);
+}
+
+bf16x2_t bf16x2_is_zero(const bf16x2_t in)
+{
+    return lanes((in.bits & 0x7FFF) == 0 ? 0xFFFF : 0,
+                 ((in.bits >> 16) & 0x7FFF) == 0 ? 0xFFFF : 0);
+}
+
+bf16x2_t bf16x2_eq(const bf16x2_t in1, const bf16x2_t in2)
+{
+    return lanes(lane_eq(in1.bits & 0xFFFF, in2.bits & 0xFFFF),
+                 lane_eq(in1.bits >> 16, in2.bits >> 16));
+}
+
+bf16x2_t bf16x2_lt(const bf16x2_t in1, const bf16x2_t in2)
+{
+    return lanes(lane_lt(in1.bits & 0xFFFF, in2.bits & 0xFFFF),
+                 lane_lt(in1.bits >> 16, in2.bits >> 16));
+}
+
+bf16x2_t bf16x2_gt(const bf16x2_t in1, const bf16x2_t in2)
+{
+    return bf16x2_lt(in2, in1);
+}
+
+bf16x2_t bf16x2_min(const bf16x2_t in1, const bf16x2_t in2)
+{
+    return lanes(lane_pick(in1.bits & 0xFFFF, in2.bits & 0xFFFF, false),
+                 lane_pick(in1.bits >> 16, in2.bits >> 16, false));
+}
+
+bf16x2_t bf16x2_max(const bf16x2_t in1, const bf16x2_t in2)
+{
+    return lanes(lane_pick(in1.bits & 0xFFFF, in2.bits & 0xFFFF, true),
+                 lane_pick(in1.bits >> 16, in2.bits >> 16, true));
+}
+
+bf16x2_t bf16x2_abs(const bf16x2_t in)
+{
+    return lanes(in.bits & 0x7FFF, (in.bits >> 16) & 0x7FFF);
+}
+
+bf16x2_t bf16x2_neg(const bf16x2_t in)
+{
+    bf16x2_t r = {in.bits ^ 0x80008000};
+    return r;
+}
+
+bf16x2_t bf16x2_copysign(const bf16x2_t mag, const bf16x2_t sign)
+{
+    bf16x2_t r = {(mag.bits & 0x7FFF7FFF) | (sign.bits & 0x80008000)};
+    return r;
+}
@@ -0,0 +1,446 @@
+/* C twin of bfloat16.S for native host builds.
+ *
+ * Every routine returns the same bits as the assembly for the same
+ * arguments, including its quirks: truncating arithmetic, the special-case
+ * order of each kernel and the masks derived from the offset arguments.
+ * The assembly derives its masks from an all-ones register; here that is
+ * simply MASK.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bfloat16.h"
+#include "trace.h"
+
+#define MASK 0xFFFFFFFFu
+
+/* bf16_tables.S, generated by bf16_tablegen.c */
+extern const uint8_t bf16_sqrt_table[256];
+extern const int8_t bf16_rsqrt_table[256];
+
+uint16_t f32_to_bf16(const uint32_t in)
+{
+    if (((in >> 23) & 0xFF) == 0xFF)
+        return in >> 16;
+    return (in + 0x7FFF + ((in >> 16) & 1)) >> 16;
+}
+
+uint32_t bf16_to_f32(const uint16_t in)
+{
+    return (uint32_t) in << 16;
+}
+
+bool is_inf(const uint32_t in,
+            const uint32_t reserv1,
+            const uint32_t reserv2,
+            const uint32_t mant_offset,
+            const uint32_t exp_offset)
+{
+    (void) reserv1;
+    (void) reserv2;
+    return !(in & (MASK >> mant_offset)) && ((in >> exp_offset) & 0xFF) == 0xFF;
+}
+
+bool is_nan(const uint32_t in,
+            const uint32_t reserv1,
+            const uint32_t reserv2,
+            const uint32_t mant_offset,
+            const uint32_t exp_offset)
+{
+    (void) reserv1;
+    (void) reserv2;
+    return (in & (MASK >> mant_offset)) && ((in >> exp_offset) & 0xFF) == 0xFF;
+}
+
+bool is_zero(const uint32_t in,
+             const uint32_t reserv1,
+             const uint32_t reserv2,
+             const uint32_t mant_exp_offset)
+{
+    (void) reserv1;
+    (void) reserv2;
+    return (in & (MASK >> mant_exp_offset)) == 0;
+}
+
+bool is_eq(const uint32_t in1,
+           const uint32_t in2,
+           const uint32_t reserv,
+           const uint32_t mant_offset,
+           const uint32_t exp_offset,
+           const uint32_t sign_offset)
+{
+    if (is_nan(in1, 0, 0, mant_offset, exp_offset) ||
+        is_nan(in2, 0, 0, mant_offset, exp_offset))
+        return false;
+    if (is_zero(in1, 0, 0, 32 - sign_offset) &&
+        is_zero(in2, 0, 0, 32 - sign_offset))
+        return true;
+    (void) reserv;
+    return in1 == in2;
+}
+
+bool is_lt(const uint32_t in1,
+           const uint32_t in2,
+           const uint32_t reserv,
+           const uint32_t mant_offset,
+           const uint32_t exp_offset,
+           const uint32_t sign_offset)
+{
+    uint32_t s1 = (in1 >> sign_offset) & 1, s2 = (in2 >> sign_offset) & 1;
+
+    (void) reserv;
+    if (is_nan(in1, 0, 0, mant_offset, exp_offset) ||
+        is_nan(in2, 0, 0, mant_offset, exp_offset))
+        return false;
+    if (is_zero(in1, 0, 0, 32 - sign_offset) &&
+        is_zero(in2, 0, 0, 32 - sign_offset))
+        return false;
+    if (s1 != s2)
+        return s1 > s2;
+    if (s1)
+        return (int32_t) in1 >= (int32_t) in2;
+    if ((int32_t) in2 < (int32_t) in1)
+        return false;
+    /* is_eq has left a3 = 32 - sign_offset by now, so the re-entry
+     * widens the mantissa mask (infinities count as NaN there) */
+    return !is_eq(in1, in2, 0, 32 - sign_offset, exp_offset, sign_offset);
+}
+
+bool is_gt(const uint32_t in1,
+           const uint32_t in2,
+           const uint32_t reserv,
+           const uint32_t mant_offset,
+           const uint32_t exp_offset,
+           const uint32_t sign_offset)
+{
+    return is_lt(in2, in1, reserv, mant_offset, exp_offset, sign_offset);
+}
+
+uint32_t my_add(const uint32_t in1,
+                const uint32_t in2,
+                const uint32_t reserv,
+                const uint32_t mant_offset,
+                const uint32_t exp_offset,
+                const uint32_t sign_offset)
+{
+    uint32_t mant_mask = MASK >> mant_offset, hidden = 1u << exp_offset;
+    uint32_t s1 = (in1 >> sign_offset) & 1, s2 = (in2 >> sign_offset) & 1;
+    int32_t e1 = (in1 >> exp_offset) & 0xFF, e2 = (in2 >> exp_offset) & 0xFF;
+    uint32_t m1 = in1 & mant_mask, m2 = in2 & mant_mask;
+    uint32_t sign, mant;
+    int32_t exp, diff;
+
+    (void) reserv;
+    if (e1 == 0 || e1 == 0xFF || e2 == 0 || e2 == 0xFF)
+        TRACE_MARK(TRACE_ID_ADD_SPECIAL);
+    if (e1 == 0xFF) {
+        if (m1 || e2 != 0xFF)
+            return in1;
+        if (m2 || s1 == s2)
+            return in2;
+        return 0x1FFu << (exp_offset - 1); /* inf - inf */
+    }
+    if (e2 == 0xFF)
+        return in2;
+    if (e1 == 0 && m1 == 0)
+        return in2;
+    if (e2 == 0 && m2 == 0)
+        return in1;
+    if (e1)
+        m1 |= hidden;
+    if (e2)
+        m2 |= hidden;
+
+    diff = e1 - e2;
+    if (diff >= 0) {
+        if (diff > 8)
+            return in1;
+        exp = e1;
+        m2 >>= diff;
+    } else {
+        if (diff < -8)
+            return in2;
+        exp = e2;
+        m1 >>= -diff;
+    }
+
+    if (s1 == s2) {
+        sign = s1;
+        mant = m1 + m2;
+        if (mant & (hidden << 1)) {
+            mant >>= 1;
+            if (++exp >= 0xFF)
+                return ((sign << 8) + 0xFF) << exp_offset;
+        }
+    } else {
+        sign = (m1 < m2) ? s2 : s1;
+        mant = (m1 < m2) ? m2 - m1 : m1 - m2;
+        if (!mant)
+            return 0;
+        while (!(mant & hidden)) {
+            mant <<= 1;
+            exp--;
+            if ((int32_t) mant <= 0)
+                return 0;
+        }
+    }
+    return (((sign << 8) | (exp & 0xFF)) << exp_offset) | (mant & mant_mask);
+}
+
+uint32_t my_sub(const uint32_t in1,
+                const uint32_t in2,
+                const uint32_t reserv,
+                const uint32_t mant_offset,
+                const uint32_t exp_offset,
+                const uint32_t sign_offset)
+{
+    return my_add(in1, in2 ^ (1u << sign_offset), reserv, mant_offset,
+                  exp_offset, sign_offset);
+}
+
+uint32_t my_fp_mul(const uint32_t in1,
+                   const uint32_t in2,
+                   const uint32_t reserv,
+                   const uint32_t mant_offset,
+                   const uint32_t exp_offset,
+                   const uint32_t sign_offset,
+                   const uint32_t oper_offset)
+{
+    uint32_t mant_mask = MASK >> mant_offset, hidden = 1u << exp_offset;
+    int32_t e1 = (in1 >> exp_offset) & 0xFF, e2 = (in2 >> exp_offset) & 0xFF;
+    uint32_t m1 = in1 & mant_mask, m2 = in2 & mant_mask;
+    uint32_t sign = ((in1 >> sign_offset) ^ (in2 >> sign_offset)) & 1;
+    uint32_t inf = ((sign << 8) + 0xFF) << exp_offset;
+    uint32_t nan = 0x1FFu << (exp_offset - 1), zero = sign << sign_offset;
+    uint32_t prod, mant;
+    int32_t exp, adjust = 0;
+
+    (void) reserv;
+    if (e1 == 0 || e1 == 0xFF || e2 == 0 || e2 == 0xFF)
+        TRACE_MARK(TRACE_ID_MUL_SPECIAL);
+    if (e1 == 0xFF) {
+        if (m1)
+            return in1;
+        return (e2 || m2) ? inf : nan;
+    }
+    if (e2 == 0xFF) {
+        if (m2)
+            return in2;
+        return (e1 || m1) ? inf : nan;
+    }
+    if ((e1 == 0 && m1 == 0) || (e2 == 0 && m2 == 0))
+        return zero;
+
+    /* subnormals are normalised into the exponent adjustment */
+    if (e1)
+        m1 |= hidden;
+    else
+        for (e1 = 1; !(m1 & hidden); adjust--)
+            m1 <<= 1;
+    if (e2)
+        m2 |= hidden;
+    else
+        for (e2 = 1; !(m2 & hidden); adjust--)
+            m2 <<= 1;
+
+    /* f32 (oper_offset 48) multiplies the top 8 significant bits only */
+    if (oper_offset == 48)
+        prod = (m1 >> 7) * (m2 >> 7);
+    else
+        prod = m1 * m2;
+    exp = e1 + e2 + adjust - 127;
+    if (prod >> 15) {
+        mant = ((prod >> exp_offset) >> 1) & 0x7F;
+        exp++;
+    } else {
+        mant = (prod >> exp_offset) & 0x7F;
+    }
+    if (exp >= 0xFF)
+        return inf;
+    if (exp <= 0) {
+        if (exp < -6)
+            return zero;
+        mant >>= 1 - exp;
+        exp = 0;
+    }
+    return (((sign << 8) | exp) << exp_offset) | mant;
+}
+
+uint32_t my_div(const uint32_t in1,
+                const uint32_t in2,
+                const uint32_t reserv,
+                const uint32_t mant_offset,
+                const uint32_t exp_offset,
+                const uint32_t sign_offset,
+                const uint32_t oper_offset)
+{
+    uint32_t mant_mask = MASK >> mant_offset, hidden = 1u << exp_offset;
+    int32_t e1 = (in1 >> exp_offset) & 0xFF, e2 = (in2 >> exp_offset) & 0xFF;
+    uint32_t m1 = in1 & mant_mask, m2 = in2 & mant_mask, quot = 0;
+    uint32_t sign = ((in1 >> sign_offset) ^ (in2 >> sign_offset)) & 1;
+    uint32_t inf = ((sign << 8) + 0xFF) << exp_offset;
+    uint32_t nan = 0x1FFu << (exp_offset - 1), zero = sign << sign_offset;
+    int32_t exp;
+
+    (void) reserv;
+    if (e1 == 0 || e1 == 0xFF || e2 == 0 || e2 == 0xFF)
+        TRACE_MARK(TRACE_ID_DIV_SPECIAL);
+    if (e2 == 0xFF) {
+        if (m2)
+            return in2;
+        return (e1 == 0xFF && !m1) ? nan : zero;
+    }
+    if (e2 == 0 && m2 == 0)
+        return (e1 || m1) ? inf : nan;
+    if (e1 == 0xFF)
+        return m1 ? in1 : inf;
+    if (e1 == 0 && m1 == 0)
+        return zero;
+    if (e1)
+        m1 |= hidden;
+    if (e2)
+        m2 |= hidden;
+
+    /* 16 quotient bits by restoring division */
+    if (oper_offset == 48)
+        m1 = (m1 >> 7) << 15;
+    else
+        m1 <<= 15;
+    for (int i = 15; i >= 0; i--) {
+        quot <<= 1;
+        if ((int32_t) m1 >= (int32_t) (m2 << i)) {
+            m1 -= m2 << i;
+            quot |= 1;
+        }
+    }
+
+    exp = e1 - e2 + 127;
+    if (!e1)
+        exp--;
+    if (!e2)
+        exp++;
+    while (!(quot >> 15) && exp > 1) {
+        quot <<= 1;
+        exp--;
+    }
+    quot >>= 8;
+    if (exp >= 0xFF)
+        return inf;
+    if (exp <= 0)
+        return zero;
+    return (((sign << 8) | exp) << exp_offset) | (quot & mant_mask);
+}
+
+/* The reciprocal engine is bit-exact with the restoring loop */
+uint32_t my_div_recip(const uint32_t in1,
+                      const uint32_t in2,
+                      const uint32_t reserv,
+                      const uint32_t mant_offset,
+                      const uint32_t exp_offset,
+                      const uint32_t sign_offset,
+                      const uint32_t oper_offset)
+{
+    return my_div(in1, in2, reserv, mant_offset, exp_offset, sign_offset,
+                  oper_offset);
+}
+
+uint32_t my_sqrt(const uint32_t in)
+{
+    uint32_t exp = (in >> 7) & 0xFF, mant = in & 0x7F, sign = (in >> 15) & 1;
+
+    if (in - 0x80 >= 0x7F00) /* not a positive normal */
+        TRACE_MARK(TRACE_ID_SQRT_SPECIAL);
+    if (exp == 0xFF)
+        return (!mant && sign) ? 0x7FC0 : in;
+    if (exp == 0 && mant == 0)
+        return 0;
+    if (sign)
+        return 0x7FC0;
+    if (exp == 0)
+        return 0;
+    return (((exp + 127) >> 1) << 7) +
+           bf16_sqrt_table[(exp & 1) << 7 | mant];
+}
+
+uint32_t bf16_rsqrt(const uint32_t in)
+{
+    uint32_t exp = (in >> 7) & 0xFF, mant = in & 0x7F, sign = (in >> 15) & 1;
+
+    if (exp == 0xFF) {
+        if (mant)
+            return in;
+        return sign ? 0x7FC0 : 0;
+    }
+    if (exp == 0)
+        return (sign << 15) | 0x7F80;
+    if (sign)
+        return 0x7FC0;
+    return ((254 - ((exp + 127) >> 1)) << 7) +
+           bf16_rsqrt_table[(exp & 1) << 7 | mant];
+}
+
+void bf16_add_n(uint16_t *dst, const uint16_t *a, const uint16_t *b,
+                uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = my_add(a[i], b[i], 0, 25, 7, 15);
+}
+
+void bf16_sub_n(uint16_t *dst, const uint16_t *a, const uint16_t *b,
+                uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = my_sub(a[i], b[i], 0, 25, 7, 15);
+}
+
+void bf16_mul_n(uint16_t *dst, const uint16_t *a, const uint16_t *b,
+                uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = my_fp_mul(a[i], b[i], 0, 25, 7, 15, 15);
+}
+
+void bf16_div_n(uint16_t *dst, const uint16_t *a, const uint16_t *b,
+                uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = my_div(a[i], b[i], 0, 25, 7, 15, 15);
+}
+
+void bf16_sqrt_n(uint16_t *dst, const uint16_t *a, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = my_sqrt(a[i]);
+}
+
+static uint16_t f32_to_bf16_rne(const uint32_t in)
+{
+    if ((in << 1) > 0xFF000000u)
+        return (in >> 16) | 0x40; /* quiet NaN */
+    return (in + 0x7FFF + ((in >> 16) & 1)) >> 16;
+}
+
+void f32_to_bf16_n(bf16x2_t *dst, const uint32_t *src, uint32_t n)
+{
+    for (; n >= 2; n -= 2, src += 2)
+        (dst++)->bits = f32_to_bf16_rne(src[0]) |
+                        (uint32_t) f32_to_bf16_rne(src[1]) << 16;
+    if (n) {
+        uint16_t tail = f32_to_bf16_rne(src[0]);
+        memcpy(dst, &tail, sizeof(tail)); /* low half, little-endian */
+    }
+}
+
+void bf16_to_f32_n(uint32_t *dst, const bf16x2_t *src, uint32_t n)
+{
+    for (; n >= 2; n -= 2, src++) {
+        *dst++ = src->bits << 16;
+        *dst++ = src->bits & 0xFFFF0000u;
+    }
+    if (n) {
+        uint16_t tail;
+        memcpy(&tail, src, sizeof(tail));
+        *dst = (uint32_t) tail << 16;
+    }
+}
@@ -0,0 +1,30 @@
+/* C twin of common.S */
+#include <stdint.h>
+
+#include "bfloat16.h"
+
+uint32_t my_mul(const uint32_t in1,
+                const uint32_t in2,
+                const uint32_t reserv1,
+                const uint32_t reserv2,
+                const uint32_t reserv3,
+                const uint32_t reserv4,
+                const uint32_t reserv5,
+                uint32_t *out2)
+{
+    uint64_t prod = (uint64_t) in1 * in2;
+
+    (void) reserv1;
+    (void) reserv2;
+    (void) reserv3;
+    (void) reserv4;
+    (void) reserv5;
+    *out2 = prod >> 32;
+    return (uint32_t) prod;
+}
+
+/* my_clz(0) is 0, not 32 */
+uint32_t my_clz(const uint32_t in)
+{
+    return in ? __builtin_clz(in) : 0;
+}
@@ -0,0 +1,87 @@
+/* C twin of hanoi.S: iterative Gray-code solution over a peg-state array,
+ * one line per move unless quiet */
+#include <stdint.h>
+
+#include "bfloat16.h"
+#include "output.h"
+
+static uint32_t hanoi_ctz(uint32_t x)
+{
+    return __builtin_ctz(x);
+}
+
+/* x % 3 by folding base-4 digits (4^k = 1 mod 3) */
+static uint32_t hanoi_mod3(uint32_t x)
+{
+    x = (x >> 16) + (x & 0xFFFF);
+    x = (x >> 8) + (x & 0xFF);
+    x = (x >> 4) + (x & 0xF);
+    x = (x >> 2) + (x & 3);
+    x = (x >> 2) + (x & 3);
+    x = (x >> 2) + (x & 3);
+    return (x >= 3) ? x - 3 : x;
+}
+
+static uint32_t hanoi_word(uint32_t disk, uint32_t from, uint32_t to)
+{
+    return (disk + 1) << 16 | from << 8 | to;
+}
+
+static uint32_t hanoi_engine(int num, int quiet)
+{
+    static const char peg_name[] = "ABC";
+    uint8_t peg[HANOI_MAX_DISKS] = {0};
+    uint32_t step = (num & 1) ? 2 : 1, sum = 0, moves;
+
+    if (num <= 0)
+        return 0;
+    if (num > HANOI_MAX_DISKS)
+        num = HANOI_MAX_DISKS;
+    moves = 1u << num;
+    for (uint32_t i = 1; i != moves; i++) {
+        uint32_t disk = hanoi_ctz(i), from = peg[disk], to;
+
+        if (disk != 0)
+            to = 3 - from - peg[0];
+        else
+            to = (from + step >= 3) ? from + step - 3 : from + step;
+        peg[disk] = to;
+        sum = (sum << 5 | sum >> 27) ^ hanoi_word(disk, from, to);
+        if (quiet)
+            continue;
+
+        out_puts("Move Disk ");
+        out_dec(disk + 1);
+        out_puts(" from ");
+        out_putc(peg_name[from]);
+        out_puts(" to ");
+        out_putc(peg_name[to]);
+        out_putc('\n');
+    }
+    return sum;
+}
+
+void hanoi(int num)
+{
+    hanoi_engine(num, 0);
+}
+
+uint32_t hanoi_checksum(int num)
+{
+    return hanoi_engine(num, 1);
+}
+
+uint32_t hanoi_move(uint32_t num, uint32_t k)
+{
+    uint32_t from, to;
+
+    if (k == 0 || num > HANOI_MAX_DISKS || k >= (1u << num))
+        return 0;
+    from = hanoi_mod3(k & (k - 1));
+    to = hanoi_mod3((k | (k - 1)) + 1);
+    if (!(num & 1)) { /* even towers end on B: swap B and C */
+        from = from ? 3 - from : 0;
+        to = to ? 3 - to : 0;
+    }
+    return hanoi_word(hanoi_ctz(k), from, to);
+}
@@ -0,0 +1,63 @@
+/* C twin of hero.S: sqrt(s(s-a)(s-b)(s-c)) with s = (a+b+c)/2 */
+#include <stdint.h>
+
+#include "bfloat16.h"
+#include "trace.h"
+
+/* the probes of hero.S, one enter/exit pair around every call */
+#define HERO_CALL(id, call) \
+    ({                      \
+        uint32_t _r;        \
+        TRACE_ENTER(id);    \
+        _r = (call);        \
+        TRACE_EXIT(id);     \
+        _r;                 \
+    })
+
+uint32_t hero(const bf16_t a, const bf16_t b, const bf16_t c)
+{
+    uint32_t s, t, p;
+
+    TRACE_ENTER(TRACE_ID_HERO);
+    HERO_CALL(TRACE_ID_MY_FP_MUL,
+              my_fp_mul(a.bits, b.bits, 0, 25, 7, 15, 15)); /* dropped */
+    s = HERO_CALL(TRACE_ID_MY_ADD, my_add(a.bits, b.bits, 0, 25, 7, 15));
+    s = HERO_CALL(TRACE_ID_MY_ADD, my_add(s, c.bits, 0, 25, 7, 15));
+    s = HERO_CALL(TRACE_ID_MY_DIV, my_div(s, 0x4000, 0, 25, 7, 15, 15));
+    t = HERO_CALL(TRACE_ID_MY_SUB, my_sub(s, a.bits, 0, 25, 7, 15));
+    p = HERO_CALL(TRACE_ID_MY_FP_MUL, my_fp_mul(t, s, 0, 25, 7, 15, 15));
+    t = HERO_CALL(TRACE_ID_MY_SUB, my_sub(s, b.bits, 0, 25, 7, 15));
+    p = HERO_CALL(TRACE_ID_MY_FP_MUL, my_fp_mul(t, p, 0, 25, 7, 15, 15));
+    t = HERO_CALL(TRACE_ID_MY_SUB, my_sub(s, c.bits, 0, 25, 7, 15));
+    p = HERO_CALL(TRACE_ID_MY_FP_MUL, my_fp_mul(t, p, 0, 25, 7, 15, 15));
+    p = HERO_CALL(TRACE_ID_MY_SQRT, my_sqrt(p));
+    TRACE_EXIT(TRACE_ID_HERO);
+    return p;
+}
+
+/* s / 2.0 the way my_div rounds it: exponent - 1, flushing exponents 0
+ * and 1 to a signed zero, inf and NaN unchanged */
+static uint32_t hero_half(uint32_t s)
+{
+    uint32_t exp = (s >> 7) & 0xFF;
+
+    if (exp - 2 < 0xFD)
+        return s - 0x80;
+    if (exp == 0xFF)
+        return s;
+    return s & 0x8000;
+}
+
+void hero_n(uint16_t *out, const uint16_t *a, const uint16_t *b,
+            const uint16_t *c, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t s, p;
+
+        s = hero_half(bf16_add(bf16_add(a[i], b[i]), c[i]));
+        p = bf16_mul(bf16_sub(s, a[i]), s);
+        p = bf16_mul(bf16_sub(s, b[i]), p);
+        p = bf16_mul(bf16_sub(s, c[i]), p);
+        out[i] = my_sqrt(p);
+    }
+}
@@ -0,0 +1,47 @@
+/* C twin of perfcounter.S. The host has no cycle/instret CSRs, so
+ * get_cycles reads the TSC (or a nanosecond clock off x86) and
+ * get_instret the perf instruction counter of this process. Where perf
+ * events are not permitted get_instret reads 0 and IPC shows as 0.00.
+ */
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+uint64_t get_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+uint64_t get_instret(void)
+{
+    static int fd = -2;
+    uint64_t count;
+
+    if (fd == -2) {
+        struct perf_event_attr attr;
+
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    if (fd < 0 || read(fd, &count, sizeof(count)) != sizeof(count))
+        return 0;
+    return count;
+}
@@ -0,0 +1,16 @@
+/* Host stand-in for start.S: libc's startup calls main, so the only jobs
+ * left are pushing out whatever output.c still has buffered at exit and,
+ * with TRACE, dumping the probe ring.
+ */
+#include <stdlib.h>
+
+#include "output.h"
+#include "trace.h"
+
+__attribute__((constructor)) static void start_host(void)
+{
+    atexit(out_flush);
+#ifdef TRACE
+    atexit(trace_dump);
+#endif
+}
@@ -0,0 +1,30 @@
+/* C twin of trace.S. The host counters are 64-bit, the ring keeps their
+ * low words like the CSR reads on the target. */
+#include <stdint.h>
+
+#include "trace.h"
+
+#ifdef TRACE
+extern uint64_t get_cycles(void);
+extern uint64_t get_instret(void);
+
+struct trace_log trace_log;
+static uint32_t trace_pos;
+
+void trace_hit(uint32_t tag)
+{
+    struct trace_rec *r = &trace_log.rec[trace_pos];
+
+    r->cycle = get_cycles();
+    r->instret = get_instret();
+    r->tag = tag;
+    if (++trace_pos == TRACE_RECORDS)
+        trace_pos = 0;
+    trace_log.hits++;
+}
+
+uint32_t trace_head(void)
+{
+    return trace_pos * sizeof(struct trace_rec);
+}
+#endif
@@ -0,0 +1,290 @@
+#include <stdint.h>
+
+#include "bfloat16.h"
+#include "q16.h"
+
+/* bf16_tables.S, generated by bf16_tablegen.c */
+extern const uint32_t q16_rsqrt_knots[2 * 65];
+extern const int32_t q16_cordic_atan[Q16_CORDIC_MAX];
+extern const int32_t q16_cordic_gain[Q16_CORDIC_MAX + 1];
+
+/* angles inside the CORDIC datapath are Q29 */
+#define Q16_TWO_PI_Q60 0x6487ED5110B4611AULL
+#define Q16_PI_Q29 1686629713
+#define Q16_HALF_PI_Q29 843314857
+
+static unsigned q16_rsqrt_seg = Q16_RSQRT_SEG_DEFAULT;
+static unsigned q16_rsqrt_iters = Q16_RSQRT_ITERS_DEFAULT;
+static unsigned q16_cordic_iters = Q16_CORDIC_DEFAULT;
+
+void q16_set_rsqrt(unsigned seg_log2, unsigned iters)
+{
+    if (seg_log2 > Q16_RSQRT_SEG_MAX)
+        seg_log2 = Q16_RSQRT_SEG_MAX;
+    if (iters > Q16_RSQRT_ITERS_MAX)
+        iters = Q16_RSQRT_ITERS_MAX;
+    q16_rsqrt_seg = seg_log2;
+    q16_rsqrt_iters = iters;
+}
+
+void q16_set_cordic(unsigned iters)
+{
+    if (iters == 0)
+        iters = 1;
+    if (iters > Q16_CORDIC_MAX)
+        iters = Q16_CORDIC_MAX;
+    q16_cordic_iters = iters;
+}
+
+/* x != 0 */
+static inline uint32_t q16_clz(uint32_t x)
+{
+#ifdef __riscv_zbb
+    return __builtin_clz(x);
+#else
+    return my_clz(x);
+#endif
+}
+
+/* a * b, all 64 bits: mul/mulhu with M, my_mul without */
+static inline uint64_t q16_mul64(uint32_t a, uint32_t b)
+{
+#if defined(__riscv_mul) || defined(HOST_BUILD)
+    return (uint64_t) a * b;
+#else
+    uint32_t hi, lo = my_mul(a, b, 0, 0, 0, 0, 0, &hi);
+
+    return (uint64_t) hi << 32 | lo;
+#endif
+}
+
+/* Q29 to Q16, rounded */
+static inline int32_t q16_from_q29(int32_t v)
+{
+    return (v + (1 << 12)) >> 13;
+}
+
+/* sqrt(x * 2^16) one result bit per step; the remainder rounds */
+uint32_t q16_sqrt(uint32_t x)
+{
+    uint64_t op = (uint64_t) x << 16, res = 0, one;
+
+    if (x == 0)
+        return 0;
+    one = (uint64_t) 1 << ((47 - q16_clz(x)) & ~1u);
+    while (one) {
+        if (op >= res + one) {
+            op -= res + one;
+            res = (res >> 1) + one;
+        }
+        else {
+            res >>= 1;
+        }
+        one >>= 2;
+    }
+    return res + (op > res);
+}
+
+/* x = 2^2k * f with f in [1, 4): r = 1/sqrt(f) in Q31 between two knots,
+ * Newton on f, then 2^(24 - k) * r */
+uint32_t q16_rsqrt(uint32_t x)
+{
+    uint32_t s, m, e, o, k, b = q16_rsqrt_seg, pos, j, frac, f, r;
+    const uint32_t *t;
+
+    if (x == 0)
+        return 0xFFFFFFFF;
+    s = q16_clz(x);
+    m = x << s;
+    e = 31 - s;
+    o = e & 1;
+    k = e >> 1;
+    t = q16_rsqrt_knots + 65 * o;
+
+    pos = m << 1; /* position inside the octave, 0.32 */
+    j = b ? (pos >> (32 - b)) << (6 - b) : 0;
+    frac = (pos << b) >> 16;
+    r = t[j] - (uint32_t) (q16_mul64(t[j] - t[j + (64 >> b)], frac) >> 16);
+
+    f = m >> (1 - o); /* Q30 */
+    for (unsigned i = 0; i < q16_rsqrt_iters; i++) {
+        uint32_t r2 = q16_mul64(r, r) >> 32;           /* Q30 */
+        uint32_t fr2 = q16_mul64(f, r2) >> 32;         /* Q28 */
+        r = q16_mul64(r, (3u << 28) - fr2) >> 29;      /* r (3 - f r^2) / 2 */
+    }
+    return (r + (1u << (6 + k))) >> (7 + k);
+}
+
+int32_t q16_recip(int32_t x)
+{
+    uint32_t d = (x < 0) ? -(uint32_t) x : (uint32_t) x, q = 0;
+    uint64_t r;
+
+    if (d <= 2)
+        return (x < 0) ? INT32_MIN : INT32_MAX;
+    /* 2^32 / d, restoring, from the highest possible quotient bit */
+    r = ((uint64_t) 1 << 32) + (d >> 1);
+    for (int k = q16_clz(d) + 1; k >= 0; k--) {
+        if (r >= (uint64_t) d << k) {
+            r -= (uint64_t) d << k;
+            q |= 1u << k;
+        }
+    }
+    return (x < 0) ? -(int32_t) q : (int32_t) q;
+}
+
+/* a reduced to [-pi, pi] by shift-subtract of 2pi * 2^k, then into
+ * [-pi/2, pi/2] with a sign flip, then CORDIC rotation from (K, 0) */
+void q16_sincos(int32_t a, int32_t *s, int32_t *c)
+{
+    uint64_t m = (uint64_t) ((a < 0) ? -(int64_t) a : a) << 13;
+    int64_t th;
+    int32_t x, y, z;
+    unsigned n = q16_cordic_iters;
+    int flip = 0;
+
+    for (int k = 13; k >= 0; k--) {
+        uint64_t d = Q16_TWO_PI_Q60 >> (31 - k);
+
+        if (m >= d)
+            m -= d;
+    }
+    th = (int64_t) m;
+    if (th > Q16_PI_Q29)
+        th -= (int64_t) (Q16_TWO_PI_Q60 >> 31);
+    if (a < 0)
+        th = -th;
+    if (th > Q16_HALF_PI_Q29) {
+        th -= Q16_PI_Q29;
+        flip = 1;
+    }
+    else if (th < -Q16_HALF_PI_Q29) {
+        th += Q16_PI_Q29;
+        flip = 1;
+    }
+
+    x = q16_cordic_gain[n];
+    y = 0;
+    z = (int32_t) th;
+    for (unsigned i = 0; i < n; i++) {
+        int32_t dx = y >> i, dy = x >> i;
+
+        if (z >= 0) {
+            x -= dx;
+            y += dy;
+            z -= q16_cordic_atan[i];
+        }
+        else {
+            x += dx;
+            y -= dy;
+            z += q16_cordic_atan[i];
+        }
+    }
+    x = q16_from_q29(x);
+    y = q16_from_q29(y);
+    *c = flip ? -x : x;
+    *s = flip ? -y : y;
+}
+
+int32_t q16_sin(int32_t a)
+{
+    int32_t s, c;
+
+    q16_sincos(a, &s, &c);
+    return s;
+}
+
+int32_t q16_cos(int32_t a)
+{
+    int32_t s, c;
+
+    q16_sincos(a, &s, &c);
+    return c;
+}
+
+/* (x, y) turned into the right half plane, scaled below 2^28, then CORDIC
+ * vectoring drives y to 0 and sums the angle */
+int32_t q16_atan2(int32_t y, int32_t x)
+{
+    uint32_t ax = (x < 0) ? -(uint32_t) x : (uint32_t) x;
+    uint32_t ay = (y < 0) ? -(uint32_t) y : (uint32_t) y;
+    int32_t vx, vy, z = 0, off = 0;
+    unsigned n = q16_cordic_iters;
+    int sh;
+
+    if ((ax | ay) == 0)
+        return 0;
+    if (x < 0)
+        off = (y >= 0) ? Q16_PI : -Q16_PI;
+    sh = (int) q16_clz(ax | ay) - 4;
+    if (sh >= 0) {
+        vx = ax << sh;
+        vy = ay << sh;
+    }
+    else {
+        vx = ax >> -sh;
+        vy = ay >> -sh;
+    }
+    if ((y < 0) != (x < 0))
+        vy = -vy;
+
+    for (unsigned i = 0; i < n; i++) {
+        int32_t tx = vx;
+
+        if (vy > 0) {
+            vx += vy >> i;
+            vy -= tx >> i;
+            z += q16_cordic_atan[i];
+        }
+        else {
+            vx -= vy >> i;
+            vy += tx >> i;
+            z -= q16_cordic_atan[i];
+        }
+    }
+    return q16_from_q29(z) + off;
+}
+
+void q16_sqrt_n(uint32_t *dst, const uint32_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = q16_sqrt(src[i]);
+}
+
+void q16_rsqrt_n(uint32_t *dst, const uint32_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = q16_rsqrt(src[i]);
+}
+
+void q16_recip_n(int32_t *dst, const int32_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = q16_recip(src[i]);
+}
+
+void q16_sin_n(int32_t *dst, const int32_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = q16_sin(src[i]);
+}
+
+void q16_cos_n(int32_t *dst, const int32_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = q16_cos(src[i]);
+}
+
+void q16_atan2_n(int32_t *dst, const int32_t *y, const int32_t *x,
+                 uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = q16_atan2(y[i], x[i]);
+}
+
+uint32_t fast_rsqrt(uint32_t x)
+{
+    if (x == 0)
+        return 0xFFFFFFFF;
+    return q16_rsqrt(x) >> 8;
+}
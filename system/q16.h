@@ -0,0 +1,57 @@
+#ifndef Q16_H
+#define Q16_H
+
+#include <stdint.h>
+
+/* Q16.16 fixed-point math (q16.c). Values carry 16 fraction bits: uint32_t
+ * for sqrt/rsqrt of nonnegative inputs, int32_t for the signed functions;
+ * angles are in radians. Results are rounded to nearest.
+ *
+ * sqrt (digit by digit), recip (restoring division) and sin/cos/atan2
+ * (CORDIC) are shifts, adds and compares only. rsqrt interpolates a table
+ * of 1/sqrt over [1, 4) with one 32x32 multiply, then refines with Newton
+ * steps of three; q16_set_rsqrt trades table resolution and steps against
+ * each other, q16_set_cordic sets the CORDIC step count.
+ */
+
+#define Q16_ONE 0x10000
+#define Q16_PI 205887 /* round(pi * 2^16) */
+
+#define Q16_RSQRT_SEG_MAX 6   /* up to 2^6 table segments per octave */
+#define Q16_RSQRT_ITERS_MAX 3 /* Newton steps */
+#define Q16_CORDIC_MAX 24     /* CORDIC steps */
+
+/* defaults, picked from the error-vs-cycles sweep in main.c */
+#define Q16_RSQRT_SEG_DEFAULT 6
+#define Q16_RSQRT_ITERS_DEFAULT 1
+#define Q16_CORDIC_DEFAULT 20
+
+void q16_set_rsqrt(unsigned seg_log2, unsigned iters);
+void q16_set_cordic(unsigned iters);
+
+uint32_t q16_sqrt(uint32_t x);
+/* x = 0 gives 0xFFFFFFFF */
+uint32_t q16_rsqrt(uint32_t x);
+/* saturates to INT32_MAX/INT32_MIN for |x| <= 2 (x = 0: INT32_MAX) */
+int32_t q16_recip(int32_t x);
+int32_t q16_sin(int32_t a);
+int32_t q16_cos(int32_t a);
+void q16_sincos(int32_t a, int32_t *s, int32_t *c);
+/* in [-pi, pi]; atan2(0, 0) = 0 */
+int32_t q16_atan2(int32_t y, int32_t x);
+
+/* Array variants: dst[i] = f(src[i]) for i < n */
+void q16_sqrt_n(uint32_t *dst, const uint32_t *src, uint32_t n);
+void q16_rsqrt_n(uint32_t *dst, const uint32_t *src, uint32_t n);
+void q16_recip_n(int32_t *dst, const int32_t *src, uint32_t n);
+void q16_sin_n(int32_t *dst, const int32_t *src, uint32_t n);
+void q16_cos_n(int32_t *dst, const int32_t *src, uint32_t n);
+void q16_atan2_n(int32_t *dst, const int32_t *y, const int32_t *x,
+                 uint32_t n);
+
+/* The original main.c entry point: 1/sqrt(x) in Q16 for an integer x,
+ * i.e. q16_rsqrt(x) >> 8; x = 0 gives 0xFFFFFFFF.
+ */
+uint32_t fast_rsqrt(uint32_t x);
+
+#endif /* Q16_H */
@@ -0,0 +1,21 @@
+#include <stdint.h>
+
+#include "fileio.h"
+#include "trace.h"
+
+#ifdef TRACE
+/* header in place, then header and ring in one write */
+void trace_dump(void)
+{
+    int fd;
+
+    trace_log.magic = TRACE_MAGIC;
+    trace_log.cap = TRACE_RECORDS;
+    trace_log.head = trace_head();
+    fd = fio_open(TRACE_FILE, FIO_WRITE);
+    if (fd < 0)
+        return;
+    fio_write(fd, &trace_log, sizeof(trace_log));
+    fio_close(fd);
+}
+#endif
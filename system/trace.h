@@ -0,0 +1,78 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+/* Entry/exit probes into an in-memory ring buffer (trace.S, trace.c).
+ *
+ * Built with make TRACE=1, TRACE_ENTER/TRACE_EXIT/TRACE_MARK record one
+ * (tag, cycle, instret) triple each; the .S files use the same macros
+ * from trace.inc. Without it they expand to nothing and trace.S/trace.c
+ * are empty. The ring keeps the last TRACE_RECORDS probes; at exit
+ * trace_dump writes header and ring to trace.bin with one write, and
+ * trace_report.py turns that into inclusive/exclusive cycles per id.
+ * Cycle and instret are the low 32 bits of the counters: only
+ * differences mean anything.
+ */
+
+#ifndef TRACE_RECORDS
+#define TRACE_RECORDS 4096
+#endif
+
+#define TRACE_FILE "trace.bin"
+#define TRACE_MAGIC 0x31435254 /* "TRC1" */
+
+/* tag = id << 2 | kind */
+#define TRACE_KIND_ENTER 0
+#define TRACE_KIND_EXIT 1
+#define TRACE_KIND_MARK 2
+
+/* ids, as in trace.inc and trace_report.py */
+enum {
+    TRACE_ID_HERO = 1,
+    TRACE_ID_MY_ADD,
+    TRACE_ID_MY_SUB,
+    TRACE_ID_MY_FP_MUL,
+    TRACE_ID_MY_DIV,
+    TRACE_ID_MY_SQRT,
+    TRACE_ID_ADD_SPECIAL, /* marks: the special-case dispatch was taken */
+    TRACE_ID_MUL_SPECIAL,
+    TRACE_ID_DIV_SPECIAL,
+    TRACE_ID_SQRT_SPECIAL,
+    TRACE_ID_USER = 32, /* first id for ad-hoc C probes, up to 511 */
+};
+
+struct trace_rec {
+    uint32_t tag;
+    uint32_t cycle;
+    uint32_t instret;
+};
+
+/* trace.bin is this struct as it sits in memory */
+struct trace_log {
+    uint32_t magic; /* set by trace_dump */
+    uint32_t hits;  /* probes since start; more than cap: the ring wrapped */
+    uint32_t cap;   /* TRACE_RECORDS, set by trace_dump */
+    uint32_t head;  /* byte offset of the next record into rec[] */
+    struct trace_rec rec[TRACE_RECORDS];
+};
+
+#ifdef TRACE
+extern struct trace_log trace_log;
+
+/* keeps every register, so assembly can call it between probes */
+void trace_hit(uint32_t tag);
+/* byte offset of the next record into trace_log.rec */
+uint32_t trace_head(void);
+void trace_dump(void);
+
+#define TRACE_ENTER(id) trace_hit((id) << 2 | TRACE_KIND_ENTER)
+#define TRACE_EXIT(id) trace_hit((id) << 2 | TRACE_KIND_EXIT)
+#define TRACE_MARK(id) trace_hit((id) << 2 | TRACE_KIND_MARK)
+#else
+#define TRACE_ENTER(id) ((void) 0)
+#define TRACE_EXIT(id) ((void) 0)
+#define TRACE_MARK(id) ((void) 0)
+#endif
+
+#endif /* TRACE_H */
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Per-probe cycle table from a trace.bin written by trace_dump (trace.h).
+
+Enter/exit pairs are matched on a stack. Inclusive counts run from enter
+to exit. Exclusive counts subtract the inclusive counts of the pairs
+nested directly inside. Marks are only counted. If the ring wrapped, the
+oldest records are gone, and exits without their enter are skipped.
+Cycle and instret are the low 32 bits, so differences are taken mod
+2^32. The probes' own cost is included, roughly 40 instructions each.
+
+usage: trace_report.py [trace.bin]
+"""
+import struct
+import sys
+
+MAGIC = 0x31435254
+KIND_ENTER, KIND_EXIT, KIND_MARK = 0, 1, 2
+
+# as in trace.h and trace.inc
+NAMES = {
+    1: "hero",
+    2: "my_add",
+    3: "my_sub",
+    4: "my_fp_mul",
+    5: "my_div",
+    6: "my_sqrt",
+    7: "add special",
+    8: "mul special",
+    9: "div special",
+    10: "sqrt special",
+}
+
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, hits, cap, head = struct.unpack_from("<4I", data)
+    if magic != MAGIC:
+        sys.exit("%s: not a trace dump" % path)
+    recs = list(struct.iter_unpack("<3I", data[16:16 + 12 * cap]))
+    if hits <= cap:
+        return hits, recs[:hits]
+    # wrapped: oldest record at head
+    h = head // 12
+    return hits, recs[h:] + recs[:h]
+
+
+def report(path):
+    hits, recs = load(path)
+    stats = {}
+    stack = []  # [id, cycle, instret, child cycles, child instret]
+
+    def row(i):
+        return stats.setdefault(i, [0, 0, 0, 0, 0, 0])
+
+    for tag, cyc, ins in recs:
+        i, kind = tag >> 2, tag & 3
+        if kind == KIND_MARK:
+            row(i)[5] += 1
+        elif kind == KIND_ENTER:
+            stack.append([i, cyc, ins, 0, 0])
+        elif stack and stack[-1][0] == i:
+            _, c0, i0, cc, ci = stack.pop()
+            dc, di = (cyc - c0) & 0xFFFFFFFF, (ins - i0) & 0xFFFFFFFF
+            r = row(i)
+            r[0] += 1
+            r[1] += dc
+            r[2] += dc - cc
+            r[3] += di
+            r[4] += di - ci
+            if stack:
+                stack[-1][3] += dc
+                stack[-1][4] += di
+
+    print("%s: %d probes, %d kept" % (path, hits, len(recs)))
+    print("  %-14s %8s %12s %12s %10s %12s %8s" %
+          ("id", "calls", "incl cyc", "excl cyc", "cyc/call",
+           "excl instr", "marks"))
+    for i, r in sorted(stats.items(), key=lambda kv: -kv[1][1]):
+        name = NAMES.get(i, "id %d" % i)
+        per = r[1] / r[0] if r[0] else 0.0
+        print("  %-14s %8d %12d %12d %10.1f %12d %8d" %
+              (name, r[0], r[1], r[2], per, r[4], r[5]))
+
+
+if __name__ == "__main__":
+    report(sys.argv[1] if len(sys.argv) > 1 else "trace.bin")